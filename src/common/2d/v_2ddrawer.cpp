@@ -42,6 +42,7 @@
 #include "v_video.h"
 #include "fcolormap.h"
 #include "texturemanager.h"
+#include "stats.h"
 
 static F2DDrawer drawer = F2DDrawer();
 F2DDrawer* twod = &drawer;
@@ -213,6 +214,246 @@ DEFINE_ACTION_FUNCTION_NATIVE(DShape2D, PushTriangle, Shape2D_PushTriangle)
 	return 0;
 }
 
+//==========================================================================
+//
+// @Cockatrice - Retained 2D layers
+//
+//==========================================================================
+
+IMPLEMENT_CLASS(DLayer2D, false, false)
+
+static int LayerReplays, LayerRecords, LayerRejects;
+
+void DLayer2D::BeginRecord(F2DDrawer *drawer)
+{
+	mValid = false;
+	mRecording = drawer;
+	mRecordCommand = drawer->mData.Size();
+	mRecordVertex = drawer->mVertices.Size();
+	mRecordIndex = drawer->mIndices.Size();
+	mRecordPrepended = drawer->mPrepended;
+	// Keep the first recorded command from being merged into what was there before.
+	drawer->mMergeBarrier = mRecordCommand;
+}
+
+//==========================================================================
+//
+// Copies everything added since BeginRecord. Returns false if that range
+// can't be replayed, e.g. because it contains shapes with their own
+// vertex buffers or the drawer got cleared or prepended to meanwhile.
+//
+//==========================================================================
+
+bool DLayer2D::EndRecord()
+{
+	auto drawer = mRecording;
+	if (drawer == nullptr) return false;
+	mRecording = nullptr;
+
+	mCommands.Clear();
+	mVertices.Clear();
+	mIndices.Clear();
+
+	unsigned numcommands = drawer->mData.Size();
+	bool usable = drawer->mPrepended == mRecordPrepended && numcommands >= mRecordCommand &&
+		drawer->mVertices.Size() >= mRecordVertex && drawer->mIndices.Size() >= mRecordIndex;
+
+	// Nothing may be merged into the recorded commands either.
+	drawer->mMergeBarrier = numcommands;
+
+	for (unsigned i = mRecordCommand; usable && i < numcommands; i++)
+	{
+		if (drawer->mData[i].shape2DBufInfo != nullptr) usable = false;
+	}
+	if (!usable)
+	{
+		LayerRejects++;
+		return false;
+	}
+
+	mCommands.Resize(numcommands - mRecordCommand);
+	for (unsigned i = 0; i < mCommands.Size(); i++)
+	{
+		auto &cmd = mCommands[i];
+		cmd = drawer->mData[mRecordCommand + i];
+		if (cmd.isSpecial != SpecialDrawCommand::NotSpecial) continue;
+		cmd.mVertIndex -= mRecordVertex;
+		cmd.mIndexIndex -= mRecordIndex;
+	}
+	mVertices.Resize(drawer->mVertices.Size() - mRecordVertex);
+	if (mVertices.Size() > 0) memcpy(mVertices.Data(), &drawer->mVertices[mRecordVertex], mVertices.Size() * sizeof(mVertices[0]));
+	mIndices.Resize(drawer->mIndices.Size() - mRecordIndex);
+	for (unsigned i = 0; i < mIndices.Size(); i++)
+	{
+		mIndices[i] = drawer->mIndices[mRecordIndex + i] - mRecordVertex;
+	}
+
+	// Bounds for dirty rect checks, in screen space.
+	mBounds[0] = mBounds[1] = FLT_MAX;
+	mBounds[2] = mBounds[3] = -FLT_MAX;
+	for (auto &cmd : mCommands)
+	{
+		if (cmd.isSpecial != SpecialDrawCommand::NotSpecial) continue;
+		for (int v = cmd.mVertIndex; v < cmd.mVertIndex + cmd.mVertCount; v++)
+		{
+			DVector3 pos(mVertices[v].x, mVertices[v].y, 1.);
+			if (cmd.useTransform) pos = cmd.transform * pos;
+			mBounds[0] = min(mBounds[0], (float)pos.X);
+			mBounds[1] = min(mBounds[1], (float)pos.Y);
+			mBounds[2] = max(mBounds[2], (float)pos.X);
+			mBounds[3] = max(mBounds[3], (float)pos.Y);
+		}
+	}
+
+	mWidth = drawer->GetWidth();
+	mHeight = drawer->GetHeight();
+	mValid = true;
+	LayerRecords++;
+	return true;
+}
+
+//==========================================================================
+//
+// Appends the recorded commands. Returns false if the owner needs to
+// draw and record again.
+//
+//==========================================================================
+
+bool DLayer2D::Draw(F2DDrawer *drawer)
+{
+	if (mRecording != nullptr || !IsValid(drawer)) return false;
+
+	int vertbase = drawer->mVertices.Reserve(mVertices.Size());
+	if (mVertices.Size() > 0) memcpy(&drawer->mVertices[vertbase], mVertices.Data(), mVertices.Size() * sizeof(mVertices[0]));
+
+	int indexbase = drawer->mIndices.Reserve(mIndices.Size());
+	for (unsigned i = 0; i < mIndices.Size(); i++)
+	{
+		drawer->mIndices[indexbase + i] = mIndices[i] + vertbase;
+	}
+
+	for (auto cmd : mCommands)
+	{
+		if (cmd.isSpecial == SpecialDrawCommand::NotSpecial)
+		{
+			cmd.mVertIndex += vertbase;
+			cmd.mIndexIndex += indexbase;
+		}
+		drawer->AddCommand(&cmd);
+	}
+	LayerReplays++;
+	return true;
+}
+
+bool DLayer2D::InvalidateRect(int x, int y, int w, int h)
+{
+	if (mValid && x < mBounds[2] && x + w > mBounds[0] && y < mBounds[3] && y + h > mBounds[1])
+	{
+		mValid = false;
+	}
+	return !mValid;
+}
+
+void DLayer2D::OnDestroy()
+{
+	mCommands.Reset();
+	mVertices.Reset();
+	mIndices.Reset();
+	mValid = false;
+	Super::OnDestroy();
+}
+
+ADD_STAT(layers2d)
+{
+	FString out;
+	int total = LayerReplays + LayerRecords + LayerRejects;
+	out.Format("2D layers: replayed=%d recorded=%d uncacheable=%d reuse=%.1f%%", LayerReplays, LayerRecords, LayerRejects, total > 0 ? LayerReplays * 100. / total : 0.);
+	LayerReplays = LayerRecords = LayerRejects = 0;
+	return out;
+}
+
+static F2DDrawer *LayerDrawer(FCanvas *canvas)
+{
+	return canvas != nullptr ? &canvas->Drawer : twod;
+}
+
+static int Layer2D_IsValid(DLayer2D *self, FCanvas *canvas)
+{
+	return self->IsValid(LayerDrawer(canvas));
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(DLayer2D, IsValid, Layer2D_IsValid)
+{
+	PARAM_SELF_PROLOGUE(DLayer2D);
+	PARAM_OBJECT(canvas, FCanvas);
+	ACTION_RETURN_BOOL(Layer2D_IsValid(self, canvas));
+}
+
+static void Layer2D_Invalidate(DLayer2D *self)
+{
+	self->Invalidate();
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(DLayer2D, Invalidate, Layer2D_Invalidate)
+{
+	PARAM_SELF_PROLOGUE(DLayer2D);
+	Layer2D_Invalidate(self);
+	return 0;
+}
+
+static int Layer2D_InvalidateRect(DLayer2D *self, int x, int y, int w, int h)
+{
+	return self->InvalidateRect(x, y, w, h);
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(DLayer2D, InvalidateRect, Layer2D_InvalidateRect)
+{
+	PARAM_SELF_PROLOGUE(DLayer2D);
+	PARAM_INT(x);
+	PARAM_INT(y);
+	PARAM_INT(w);
+	PARAM_INT(h);
+	ACTION_RETURN_BOOL(Layer2D_InvalidateRect(self, x, y, w, h));
+}
+
+static void Layer2D_BeginRecord(DLayer2D *self, FCanvas *canvas)
+{
+	self->BeginRecord(LayerDrawer(canvas));
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(DLayer2D, BeginRecord, Layer2D_BeginRecord)
+{
+	PARAM_SELF_PROLOGUE(DLayer2D);
+	PARAM_OBJECT(canvas, FCanvas);
+	Layer2D_BeginRecord(self, canvas);
+	return 0;
+}
+
+static int Layer2D_EndRecord(DLayer2D *self)
+{
+	return self->EndRecord();
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(DLayer2D, EndRecord, Layer2D_EndRecord)
+{
+	PARAM_SELF_PROLOGUE(DLayer2D);
+	ACTION_RETURN_BOOL(Layer2D_EndRecord(self));
+}
+
+static int Layer2D_Draw(DLayer2D *self, FCanvas *canvas)
+{
+	if (!self->Draw(LayerDrawer(canvas))) return false;
+	if (canvas != nullptr) canvas->Tex->NeedUpdate();
+	return true;
+}
+
+DEFINE_ACTION_FUNCTION_NATIVE(DLayer2D, Draw, Layer2D_Draw)
+{
+	PARAM_SELF_PROLOGUE(DLayer2D);
+	PARAM_OBJECT(canvas, FCanvas);
+	ACTION_RETURN_BOOL(Layer2D_Draw(self, canvas));
+}
+
 //==========================================================================
 //
 //
@@ -222,7 +463,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(DShape2D, PushTriangle, Shape2D_PushTriangle)
 int F2DDrawer::AddCommand(RenderCommand *data) 
 {
 	data->mScreenFade = screenFade;
-	if (mData.Size() > 0 && data->isCompatible(mData.Last()))
+	if (mData.Size() > mMergeBarrier && data->isCompatible(mData.Last()))
 	{
 		// Merge with the last command.
 		mData.Last().mIndexCount += data->mIndexCount;
@@ -1030,6 +1271,7 @@ void F2DDrawer::AddColorOnlyQuad(int x1, int y1, int w, int h, PalEntry color, F
 		// This ensures they are below the HUD, not above it.
 		dg.mScreenFade = screenFade;
 		mData.Insert(0, dg);
+		mPrepended++;
 	}
 }
 
@@ -1203,6 +1445,7 @@ void F2DDrawer::Clear()
 		mIndices.Clear();
 		mData.Clear();
 		mIsFirstPass = true;
+		mMergeBarrier = 0;
 	}
 	screenFade = 1.f;
 }
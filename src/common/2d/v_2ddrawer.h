@@ -198,6 +198,8 @@ public:
 	float screenFade = 1.f;
 	DVector2 offset;
 	DMatrix3x3 transform;
+	unsigned mMergeBarrier = 0;	// @Cockatrice - Commands below this index belong to a recorded layer and must not be merged into
+	int mPrepended = 0;
 public:
 	int fullscreenautoaspect = 3;
 	int cliptop = -1, clipleft = -1, clipwidth = -1, clipheight = -1;
@@ -323,6 +325,44 @@ public:
 	void OnDestroy() override;
 };
 
+//===========================================================================
+//
+// @Cockatrice - Retained 2D layer
+//
+// Records what a UI element draws between BeginRecord and EndRecord and
+// appends a copy of it on later frames, skipping the script calls that
+// produced it, until the layer is invalidated. Everything is stored in
+// screen space, so the owner has to invalidate it whenever the content,
+// the position, offsets or the clip rect change. Size changes of the
+// target drawer are caught here.
+//
+//===========================================================================
+
+class DLayer2D : public DObject
+{
+	DECLARE_CLASS(DLayer2D, DObject)
+public:
+	TArray<F2DDrawer::RenderCommand> mCommands;
+	TArray<F2DDrawer::TwoDVertex> mVertices;
+	TArray<int> mIndices;
+
+	F2DDrawer *mRecording = nullptr;
+	unsigned mRecordCommand = 0, mRecordVertex = 0, mRecordIndex = 0;
+	int mRecordPrepended = 0;
+
+	int mWidth = -1, mHeight = -1;
+	float mBounds[4] = {};	// x1, y1, x2, y2
+	bool mValid = false;
+
+	bool IsValid(F2DDrawer *drawer) const { return mValid && drawer->GetWidth() == mWidth && drawer->GetHeight() == mHeight; }
+	void Invalidate() { mValid = false; }
+	bool InvalidateRect(int x, int y, int w, int h);
+	void BeginRecord(F2DDrawer *drawer);
+	bool EndRecord();
+	bool Draw(F2DDrawer *drawer);
+	void OnDestroy() override;
+};
+
 
 //===========================================================================
 // 
@@ -44,6 +44,8 @@
 #include "vm.h"
 #include "printf.h"
 
+EXTERN_CVAR(Bool, r_fontatlas)
+
 
 int ListGetInt(VMVa_List &tags);
 
@@ -280,6 +282,11 @@ void DrawTextCommon(F2DDrawer *drawer, FFont *font, int normalcolor, double x, d
 	double scalex = parms.scalex * parms.patchscalex;
 	double scaley = parms.scaley * parms.patchscaley;
 
+	// @Cockatrice - Atlas glyphs set the source rect per character, non-atlas ones in the same string need the caller's back
+	const double srcx = parms.srcx, srcy = parms.srcy, srcwidth = parms.srcwidth, srcheight = parms.srcheight;
+	const bool useatlas = r_fontatlas;
+	if (useatlas) font->BuildAtlas();
+
 	if (parms.celly == 0) parms.celly = font->GetHeight() + 1;
 	parms.celly = int (parms.celly * scaley);
 
@@ -332,7 +339,7 @@ void DrawTextCommon(F2DDrawer *drawer, FFont *font, int normalcolor, double x, d
 			continue;
 		}
 
-		FFont::CharData chr = font->GetChar(c, currentcolor);
+		FFont::CharData chr = useatlas ? font->GetAtlasChar(c, currentcolor) : font->GetChar(c, currentcolor);
 		w = chr.XMove;
 		if (w == INT_MIN) w = font->GetSpaceWidth();
 
@@ -356,8 +363,22 @@ void DrawTextCommon(F2DDrawer *drawer, FFont *font, int normalcolor, double x, d
 				chWidth = chr.tCharW / pic->GetScaleX();
 				chHeight = chr.tCharH / pic->GetScaleY();
 			}
+			else
+			{
+				parms.srcx = srcx;
+				parms.srcy = srcy;
+				parms.srcwidth = srcwidth;
+				parms.srcheight = srcheight;
+			}
 
 			SetTextureParms(drawer, &parms, chr.OriginalPic, cx, cy, chWidth, chHeight);
+
+			if (chr.tAtlas)
+			{
+				// The page has no offsets of its own.
+				parms.left = parms.flipoffsets && parms.flipX ? parms.texwidth - chr.tLeft : chr.tLeft;
+				parms.top = parms.flipoffsets && parms.flipY ? parms.texheight - chr.tTop : chr.tTop;
+			}
 			
 			
 			if (parms.cellx)
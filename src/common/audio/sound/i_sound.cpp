@@ -154,6 +154,10 @@ public:
 	{
 		return 0;
 	}
+	unsigned int GetSampleRate(SoundHandle sfx)
+	{
+		return 0;
+	}
 	float GetOutputRate()
 	{
 		return 11025;	// Lies!
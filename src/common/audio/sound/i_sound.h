@@ -111,6 +111,7 @@ public:
 	virtual void UnloadSound (SoundHandle sfx) = 0;	// unloads a sound from memory
 	virtual unsigned int GetMSLength(SoundHandle sfx) = 0;	// Gets the length of a sound at its default frequency
 	virtual unsigned int GetSampleLength(SoundHandle sfx) = 0;	// Gets the length of a sound at its default frequency
+	virtual unsigned int GetSampleRate(SoundHandle sfx) = 0;	// @Cockatrice - Gets the default frequency of a sound
 	virtual float GetOutputRate() = 0;
 
 	// Streaming sounds.
@@ -130,6 +131,9 @@ public:
 	// Changes a channel's pitch.
 	virtual void ChannelPitch(FISoundChannel *chan, float volume) = 0;
 
+	// Muffles a channel that is heard through walls. 1 for both means unoccluded.
+	virtual void ChannelOcclusion(FISoundChannel *chan, float gain, float gainhf) {}
+
 	// Marks a channel's start time without actually playing it.
 	virtual void MarkStartTime (FISoundChannel *chan, float startTime = 0.f) = 0;
 
@@ -160,6 +164,9 @@ public:
 	virtual void UpdateListener (SoundListener *) = 0;
 	virtual void UpdateSounds () = 0;
 
+	// Builds a reverb environment's effect ahead of the listener entering it.
+	virtual void PrecacheEnvironment (const ReverbContainer *env) {}
+
 	virtual bool IsValid () = 0;
 	virtual void PrintStatus () = 0;
 	virtual void PrintDriversList () = 0;
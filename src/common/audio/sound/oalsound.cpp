@@ -61,6 +61,8 @@ CVAR(Bool, snd_waterreverb, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 CVAR (String, snd_aldevice, "Default", CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 CVAR (Bool, snd_efx, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 CVAR (String, snd_alresampler, "Default", CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+CVAR (Int, snd_streamreadahead, 1000, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)	// ms of audio each stream decodes ahead of playback
+CVAR (Int, snd_reverbfade, 250, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)		// ms to crossfade between reverb environments
 
 #ifdef _WIN32
 #define OPENALLIB "openal32.dll"
@@ -165,6 +167,60 @@ static ALvoid AL_APIENTRY _wrap_ProcessUpdatesSOFT(void)
 }
 
 
+//==========================================================================
+//
+// Decoded audio waiting to be queued on a stream's source. The decoder
+// thread is the only writer and the stream thread the only reader, so the
+// two positions are all the synchronization there is. The ring is made of
+// whole chunks, so a chunk can be decoded into and uploaded from in place.
+//
+//==========================================================================
+
+class FStreamRing
+{
+	TArray<ALubyte> Buffer;
+	unsigned ChunkSize = 0, NumChunks = 0;
+	std::atomic<unsigned> WritePos{ 0 }, ReadPos{ 0 };	// Counted in chunks, only ever increase
+
+public:
+	void Init(unsigned chunksize, unsigned numchunks)
+	{
+		ChunkSize = chunksize;
+		NumChunks = numchunks;
+		Buffer.Resize(chunksize * numchunks);
+		Reset();
+	}
+
+	// Neither side may be active.
+	void Reset()
+	{
+		WritePos.store(0);
+		ReadPos.store(0);
+	}
+
+	unsigned Capacity() const { return NumChunks; }
+	unsigned Filled() const { return WritePos.load(std::memory_order_acquire) - ReadPos.load(std::memory_order_acquire); }
+
+	// Producer
+	ALubyte *WriteChunk()
+	{
+		unsigned pos = WritePos.load(std::memory_order_relaxed);
+		if (pos - ReadPos.load(std::memory_order_acquire) >= NumChunks) return nullptr;
+		return &Buffer[(pos % NumChunks) * ChunkSize];
+	}
+	void CommitWrite() { WritePos.fetch_add(1, std::memory_order_release); }
+
+	// Consumer
+	const ALubyte *ReadChunk()
+	{
+		unsigned pos = ReadPos.load(std::memory_order_relaxed);
+		if (WritePos.load(std::memory_order_acquire) == pos) return nullptr;
+		return &Buffer[(pos % NumChunks) * ChunkSize];
+	}
+	void CommitRead() { ReadPos.fetch_add(1, std::memory_order_release); }
+};
+
+
 class OpenALSoundStream : public SoundStream
 {
 	OpenALSoundRenderer *Renderer;
@@ -172,8 +228,6 @@ class OpenALSoundStream : public SoundStream
 	SoundStreamCallback Callback;
 	void *UserData;
 
-	TArray<ALubyte> Data;
-
 	ALsizei SampleRate;
 	ALenum Format;
 	ALsizei FrameSize;
@@ -182,6 +236,16 @@ class OpenALSoundStream : public SoundStream
 	ALuint Buffers[BufferCount];
 	ALuint Source;
 
+	// @Cockatrice - The callback runs on the renderer's decoder thread and fills Ring ahead
+	// of playback, Process() only moves finished chunks into AL buffers.
+	FStreamRing Ring;
+	unsigned ChunkSize = 0;
+	ALuint IdleBuffers[BufferCount];	// Played buffers the ring had no data for yet
+	int NumIdle = 0;
+	std::atomic<bool> Ended{ false };	// The callback ran out of data
+	std::atomic<bool> Waiting{ false };	// Process() is waiting for the decoder
+	std::atomic<unsigned> Starved{ 0 }, Underruns{ 0 };
+
 	std::atomic<bool> Playing;
 	//bool Looping;
 	ALfloat Volume;
@@ -219,8 +283,7 @@ class OpenALSoundStream : public SoundStream
 		{
 			alSourcef(Source, AL_ROOM_ROLLOFF_FACTOR, 0.f);
 			alSourcef(Source, AL_AIR_ABSORPTION_FACTOR, 0.f);
-			alSourcei(Source, AL_DIRECT_FILTER, AL_FILTER_NULL);
-			alSource3i(Source, AL_AUXILIARY_SEND_FILTER, 0, 0, AL_FILTER_NULL);
+			Renderer->SetSourceSends(Source, false);
 		}
 		if(Renderer->AL.EXT_SOURCE_RADIUS)
 			alSourcef(Source, AL_SOURCE_RADIUS, 0.f);
@@ -272,18 +335,26 @@ public:
 		alGetError();
 
 		/* Clear the buffer queue, then fill and queue each buffer */
+		std::unique_lock<std::mutex> lock(Renderer->DecodeLock);
 		Offset = 0;
+		NumIdle = 0;
+		Ring.Reset();
+		Ended.store(false);
+		Waiting.store(false);
 		alSourcei(Source, AL_BUFFER, 0);
 		for(int i = 0;i < BufferCount;i++)
 		{
-			if(!Callback(this, &Data[0], Data.Size(), UserData))
+			// The first free chunk is only used as scratch space here, the ring stays empty.
+			ALubyte *chunk = Ring.WriteChunk();
+			if(!Callback(this, chunk, ChunkSize, UserData))
 			{
+				Ended.store(true);
 				if(i == 0)
 					return false;
 				break;
 			}
 
-			alBufferData(Buffers[i], Format, &Data[0], Data.Size(), SampleRate);
+			alBufferData(Buffers[i], Format, chunk, ChunkSize, SampleRate);
 			alSourceQueueBuffers(Source, 1, &Buffers[i]);
 		}
 		if(getALError() != AL_NO_ERROR)
@@ -294,9 +365,43 @@ public:
 			return false;
 
 		Playing.store(true);
+		lock.unlock();
+		Renderer->DecodeWake.notify_all();
+		return true;
+	}
+
+	// Called on the decoder thread with DecodeLock held. Decodes at most one chunk
+	// so a single stream can't hold up the others.
+	bool DecodeChunk()
+	{
+		if(!Playing.load() || Ended.load())
+			return false;
+
+		ALubyte *chunk = Ring.WriteChunk();
+		if(chunk == nullptr)
+			return false;
+
+		if(!Callback(this, chunk, ChunkSize, UserData))
+		{
+			Ended.store(true);
+			return false;
+		}
+		Ring.CommitWrite();
 		return true;
 	}
 
+	bool IsWaiting() const
+	{
+		return Waiting.load();
+	}
+
+	FString GetRingStats() const
+	{
+		double chunkms = 1000. * ChunkSize / (FrameSize * (double)SampleRate);
+		return FStringf("%.0f/%.0fms buffered, %u starved, %u underruns%s", Ring.Filled() * chunkms, Ring.Capacity() * chunkms,
+			Starved.load(), Underruns.load(), Ended.load() ? ", ended" : "");
+	}
+
 	virtual void Stop()
 	{
 		if(!Playing.load())
@@ -372,7 +477,7 @@ public:
 		// If the source is stopped, there was an underrun, so the play position is
 		// the end of the queue.
 		if(state == AL_STOPPED)
-			return Position{Offset + queued*(Data.Size()/FrameSize), nanoseconds{offset[1]}};
+			return Position{Offset + queued*(ChunkSize/FrameSize), nanoseconds{offset[1]}};
 		// The offset is otherwise valid as long as the source has been started.
 		if(state != AL_INITIAL)
 			return Position{Offset + offset[0], nanoseconds{offset[1]}};
@@ -414,7 +519,8 @@ public:
 			stats += ", paused";
 		if(state == AL_PLAYING)
 			stats += ", playing";
-		stats.AppendFormat(", %uHz", SampleRate);
+		stats.AppendFormat(", %uHz, ", SampleRate);
+		stats += GetRingStats();
 		if(!Playing)
 			stats += " XX";
 		return stats;
@@ -437,40 +543,48 @@ public:
 			return false;
 		}
 
-		// For each processed buffer in the queue...
+		// Unqueue the played buffers...
 		while(processed > 0)
 		{
-			ALuint bufid;
-
-			// Unqueue the oldest buffer, fill it with more data, and queue it
-			// on the end
-			{
-				std::lock_guard _{Mutex};
-				alSourceUnqueueBuffers(Source, 1, &bufid);
-				Offset += Data.Size() / FrameSize;
-				processed--;
-			}
+			std::lock_guard _{Mutex};
+			alSourceUnqueueBuffers(Source, 1, &IdleBuffers[NumIdle++]);
+			Offset += ChunkSize / FrameSize;
+			processed--;
+		}
 
-			if(Callback(this, &Data[0], Data.Size(), UserData))
-			{
-				alBufferData(bufid, Format, &Data[0], Data.Size(), SampleRate);
-				alSourceQueueBuffers(Source, 1, &bufid);
-			}
+		// ...and queue them again with what the decoder has ready.
+		bool consumed = false;
+		const ALubyte *chunk;
+		while(NumIdle > 0 && (chunk = Ring.ReadChunk()) != nullptr)
+		{
+			ALuint bufid = IdleBuffers[--NumIdle];
+			alBufferData(bufid, Format, chunk, ChunkSize, SampleRate);
+			alSourceQueueBuffers(Source, 1, &bufid);
+			Ring.CommitRead();
+			consumed = true;
 		}
+		bool ended = Ended.load();
+		Waiting.store(NumIdle > 0 && !ended);
+		if(NumIdle > 0 && !ended)
+			Starved++;
+		if(consumed)
+			Renderer->DecodeWake.notify_one();
 
 		// If the source is not playing or paused, and there are buffers queued,
-		// then there was an underrun. Restart the source.
+		// then there was an underrun. Restart the source. Without queued buffers
+		// it has either finished or is waiting for the decoder.
 		bool ok = (getALError()==AL_NO_ERROR);
 		if(ok && state != AL_PLAYING && state != AL_PAUSED)
 		{
 			ALint queued = 0;
 			alGetSourcei(Source, AL_BUFFERS_QUEUED, &queued);
 
-			ok = (getALError() == AL_NO_ERROR) && (queued > 0);
-			if(ok)
+			ok = (getALError() == AL_NO_ERROR) && (queued > 0 || !ended);
+			if(ok && queued > 0)
 			{
 				alSourcePlay(Source);
 				ok = (getALError()==AL_NO_ERROR);
+				Underruns++;
 			}
 		}
 
@@ -531,7 +645,12 @@ public:
 
 		buffbytes += FrameSize-1;
 		buffbytes -= buffbytes%FrameSize;
-		Data.Resize(buffbytes);
+		ChunkSize = buffbytes;
+
+		// Enough chunks for snd_streamreadahead, and never fewer than there are AL buffers.
+		double chunkms = 1000. * buffbytes / (FrameSize * (double)samplerate);
+		int chunks = chunkms > 0 ? (int)ceil(snd_streamreadahead / chunkms) : 0;
+		Ring.Init(buffbytes, clamp<int>(chunks, BufferCount, 64));
 
 		return true;
 	}
@@ -602,7 +721,7 @@ static void LoadALCFunc(ALCdevice *device, const char *name, T *x)
 #define LOAD_FUNC(x)  (LoadALFunc(#x, &x))
 #define LOAD_DEV_FUNC(d, x)  (LoadALCFunc(d, #x, &x))
 OpenALSoundRenderer::OpenALSoundRenderer()
-	: QuitThread(false), QuitQueueThread(false), Device(NULL), Context(NULL), SFXPaused(0), PrevEnvironment(NULL), EnvSlot(0)
+	: QuitThread(false), QuitQueueThread(false), QuitDecodeThread(false), Device(NULL), Context(NULL), SFXPaused(0), PrevEnvironment(NULL), EnvSlot(0), EnvFadeSlot(0), LastBatchSize(0)
 {
 	EnvFilters[0] = EnvFilters[1] = 0;
 
@@ -657,6 +776,12 @@ OpenALSoundRenderer::OpenALSoundRenderer()
 		attribs.Push(ALC_OUTPUT_LIMITER_SOFT);
 		attribs.Push(ALC_TRUE);
 	}
+	// Two sends, so environments can be crossfaded
+	if(*snd_efx && ALC.EXT_EFX)
+	{
+		attribs.Push(ALC_MAX_AUXILIARY_SENDS);
+		attribs.Push(2);
+	}
 	// Other attribs..?
 	attribs.Push(0);
 
@@ -867,8 +992,37 @@ OpenALSoundRenderer::OpenALSoundRenderer()
 	}
 
 	if(EnvSlot)
+	{
 		Printf("  EFX enabled\n");
 
+		ALCint sends = 1;
+		alcGetIntegerv(Device, ALC_MAX_AUXILIARY_SENDS, 1, &sends);
+		if(getALCError(Device) == AL_NO_ERROR && sends >= 2)
+		{
+			alGenAuxiliaryEffectSlots(1, &EnvFadeSlot);
+			if(getALError() == AL_NO_ERROR)
+				alAuxiliaryEffectSlotf(EnvFadeSlot, AL_EFFECTSLOT_GAIN, 0.f);
+			if(getALError() != AL_NO_ERROR)
+			{
+				alDeleteAuxiliaryEffectSlots(1, &EnvFadeSlot);
+				EnvFadeSlot = 0;
+				getALError();
+			}
+		}
+
+		TArray<ALuint> filters(Sources.Size(), true);
+		alGenFilters(filters.Size(), filters.Data());
+		if(getALError() == AL_NO_ERROR)
+		{
+			for(unsigned i = 0; i < filters.Size(); i++)
+			{
+				alFilteri(filters[i], AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+				OcclusionFilters[Sources[i]] = filters[i];
+			}
+			getALError();
+		}
+	}
+
 	if(AL.SOFT_source_resampler && strcmp(*snd_alresampler, "Default") != 0)
 	{
 		const ALint num_resamplers = alGetInteger(AL_NUM_RESAMPLERS_SOFT);
@@ -890,6 +1044,7 @@ OpenALSoundRenderer::OpenALSoundRenderer()
 	}
 
 	StreamThread = std::thread(std::mem_fn(&OpenALSoundRenderer::BackgroundProc), this);
+	DecodeThread = std::thread(std::mem_fn(&OpenALSoundRenderer::DecodeProc), this);
 	QueueThread = std::thread(std::mem_fn(&OpenALSoundRenderer::BackgroundQueueProc), this);
 }
 #undef LOAD_DEV_FUNC
@@ -900,6 +1055,15 @@ OpenALSoundRenderer::~OpenALSoundRenderer()
 	if(!Device)
 		return;
 
+	if(DecodeThread.joinable())
+	{
+		std::unique_lock<std::mutex> lock(DecodeLock);
+		QuitDecodeThread.store(true);
+		lock.unlock();
+		DecodeWake.notify_all();
+		DecodeThread.join();
+	}
+
 	if(StreamThread.joinable())
 	{
 		std::unique_lock<std::mutex> lock(StreamLock);
@@ -937,6 +1101,14 @@ OpenALSoundRenderer::~OpenALSoundRenderer()
 	}
 	EnvEffects.Clear();
 
+	for(auto &filter : OcclusionFilters)
+		alDeleteFilters(1, &filter.second);
+	OcclusionFilters.clear();
+
+	if(EnvFadeSlot)
+		alDeleteAuxiliaryEffectSlots(1, &EnvFadeSlot);
+	EnvFadeSlot = 0;
+
 	if(EnvSlot)
 	{
 		alDeleteAuxiliaryEffectSlots(1, &EnvSlot);
@@ -977,6 +1149,43 @@ void OpenALSoundRenderer::BackgroundProc()
 }
 
 
+//==========================================================================
+//
+// Runs the stream callbacks ahead of playback. Streams only get added and
+// removed with both StreamLock and DecodeLock held, so DecodeLock alone is
+// enough to walk the list here.
+//
+//==========================================================================
+
+void OpenALSoundRenderer::DecodeProc()
+{
+	std::unique_lock<std::mutex> lock(DecodeLock);
+
+	while (!QuitDecodeThread.load())
+	{
+		bool decoded = false, wake = false;
+		for (auto stream : Streams)
+		{
+			if (stream->DecodeChunk())
+			{
+				decoded = true;
+				wake |= stream->IsWaiting();
+			}
+		}
+		if (wake) StreamWake.notify_all();
+
+		if (decoded)
+		{
+			// Give Play() and stream removal a chance between chunks.
+			lock.unlock();
+			std::this_thread::yield();
+			lock.lock();
+		}
+		else DecodeWake.wait_for(lock, std::chrono::milliseconds(50));
+	}
+}
+
+
 void OpenALSoundRenderer::BackgroundQueueProc()
 {
 	std::unique_lock<std::mutex> threadLocker(QueueThreadLock);
@@ -990,6 +1199,10 @@ void OpenALSoundRenderer::BackgroundQueueProc()
 		OpenALQueueItem playInfo;
 		while (PlayQueue.dequeue(playInfo)) {
 			if (playInfo.rolloff.RolloffType >= 0) StartSound3D(playInfo); else StartSound(playInfo);
+			{
+				std::lock_guard<std::mutex> lock(UpdateLock);
+				PlayedSerials[playInfo.source] = playInfo.serial;
+			}
 			played = true;
 
 			OpenALPlayedItem pl = {
@@ -1005,6 +1218,9 @@ void OpenALSoundRenderer::BackgroundQueueProc()
 			PlayedQueue.queue(pl);
 		}
 
+		// Parameter updates come after the plays so they also reach sounds started this frame.
+		ApplyUpdates();
+
 		if (!played) QueueWake.wait_for(threadLocker, std::chrono::milliseconds(5));
 	}
 }
@@ -1013,7 +1229,9 @@ void OpenALSoundRenderer::BackgroundQueueProc()
 void OpenALSoundRenderer::AddStream(OpenALSoundStream *stream)
 {
 	std::unique_lock<std::mutex> lock(StreamLock);
+	std::unique_lock<std::mutex> decodelock(DecodeLock);
 	Streams.Push(stream);
+	decodelock.unlock();
 	lock.unlock();
 	// There's a stream to play, make sure the background thread is aware
 	StreamWake.notify_all();
@@ -1022,6 +1240,7 @@ void OpenALSoundRenderer::AddStream(OpenALSoundStream *stream)
 void OpenALSoundRenderer::RemoveStream(OpenALSoundStream *stream)
 {
 	std::unique_lock<std::mutex> lock(StreamLock);
+	std::unique_lock<std::mutex> decodelock(DecodeLock);
 	unsigned int idx = Streams.Find(stream);
 	if(idx < Streams.Size())
 		Streams.Delete(idx);
@@ -1035,42 +1254,16 @@ void OpenALSoundRenderer::SetSfxVolume(float volume)
 	FSoundChan *schan = soundEngine->GetChannels();
 	while(schan)
 	{
-		if(schan->SysChannel != NULL)
+		// Sounds that haven't started yet will pick up the new volume when they do.
+		OpenALSourceUpdate *upd = RecordSourceUpdate(schan);
+		if (upd)
 		{
-			ALuint source = GET_PTRID(schan->SysChannel);
-			SFXStatus *status = statusForSource(source);
-
-			volume = SfxVolume;
-
-			//alDeferUpdatesSOFT();
-
-			if (!status || status->state != AL_INITIAL) {
-				alSourcef(source, AL_MAX_GAIN, volume);
-				alSourcef(source, AL_GAIN, volume * schan->Volume);
-			}
-			else {
-				//alProcessUpdatesSOFT();
-
-				// The sound is most likely being played right now
-				// Flush the queue and wait to see if it plays so we can stop it immediately
-				FlushPlayQueue();
-				UpdatePlayedSounds();
-
-				// Now the state may have changed, change volume
-				if (status->state != AL_INITIAL) {
-					//alDeferUpdatesSOFT();
-
-					alSourcef(source, AL_MAX_GAIN, volume);
-					alSourcef(source, AL_GAIN, volume * schan->Volume);
-				}
-			}
+			upd->dirty |= SRCUPD_MAXGAIN | SRCUPD_GAIN;
+			upd->maxGain = volume;
+			upd->gain = volume * schan->Volume;
 		}
 		schan = schan->NextChan;
 	}
-
-	//alProcessUpdates`);
-	
-	getALError();
 }
 
 void OpenALSoundRenderer::SetMusicVolume(float volume)
@@ -1114,6 +1307,19 @@ unsigned int OpenALSoundRenderer::GetSampleLength(SoundHandle sfx)
 	return 0;
 }
 
+unsigned int OpenALSoundRenderer::GetSampleRate(SoundHandle sfx)
+{
+	if(sfx.data)
+	{
+		ALuint buffer = GET_PTRID(sfx.data);
+		ALint freq;
+		alGetBufferi(buffer, AL_FREQUENCY, &freq);
+		if(getALError() == AL_NO_ERROR)
+			return freq;
+	}
+	return 0;
+}
+
 float OpenALSoundRenderer::GetOutputRate()
 {
 	ALCint rate = 44100; // Default, just in case
@@ -1373,6 +1579,7 @@ FISoundChannel *OpenALSoundRenderer::StartSound(SoundHandle sfx, float vol, floa
 		!(chanflags&SNDF_NOREVERB), 
 		!(chanflags&SNDF_NOPAUSE), WasInWater
 	};
+	status.serial = playInfo.serial = ++PlaySerial;
 
 	SfxGroup[playInfo.source] = status;
 
@@ -1488,6 +1695,7 @@ FISoundChannel *OpenALSoundRenderer::StartSound3D(SoundHandle sfx, SoundListener
 		!(chanflags&SNDF_NOREVERB),
 		!(chanflags&SNDF_NOPAUSE), WasInWater
 	};
+	status.serial = playInfo.serial = ++PlaySerial;
 
 	SfxGroup[source] = status;
 
@@ -1535,16 +1743,7 @@ bool OpenALSoundRenderer::StartSound(OpenALQueueItem &playInfo)
 	// Set environment
 	if (playInfo.envSlot)
 	{
-		if (!(playInfo.chanflags&SNDF_NOREVERB))
-		{
-			alSourcei(source, AL_DIRECT_FILTER, EnvFilters[0]);
-			alSource3i(source, AL_AUXILIARY_SEND_FILTER, playInfo.envSlot, 0, EnvFilters[1]);
-		}
-		else
-		{
-			alSourcei(source, AL_DIRECT_FILTER, AL_FILTER_NULL);
-			alSource3i(source, AL_AUXILIARY_SEND_FILTER, 0, 0, AL_FILTER_NULL);
-		}
+		SetSourceSends(source, !(playInfo.chanflags&SNDF_NOREVERB));
 		alSourcef(source, AL_ROOM_ROLLOFF_FACTOR, 0.f);
 	}
 
@@ -1681,16 +1880,7 @@ bool OpenALSoundRenderer::StartSound3D(OpenALQueueItem &playInfo)
 
 	if (EnvSlot)
 	{
-		if (!(playInfo.chanflags&SNDF_NOREVERB))
-		{
-			alSourcei(source, AL_DIRECT_FILTER, EnvFilters[0]);
-			alSource3i(source, AL_AUXILIARY_SEND_FILTER, EnvSlot, 0, EnvFilters[1]);
-		}
-		else
-		{
-			alSourcei(source, AL_DIRECT_FILTER, AL_FILTER_NULL);
-			alSource3i(source, AL_AUXILIARY_SEND_FILTER, 0, 0, AL_FILTER_NULL);
-		}
+		SetSourceSends(source, !(playInfo.chanflags&SNDF_NOREVERB));
 		alSourcef(source, AL_ROOM_ROLLOFF_FACTOR, 0.f);
 	}
 
@@ -1746,35 +1936,47 @@ bool OpenALSoundRenderer::StartSound3D(OpenALQueueItem &playInfo)
 
 void OpenALSoundRenderer::ChannelVolume(FISoundChannel *chan, float volume)
 {
-	if(chan == NULL || chan->SysChannel == NULL)
+	OpenALSourceUpdate *upd = RecordSourceUpdate(chan);
+	if (upd == nullptr)
 		return;
 
-	//alDeferUpdatesSOFT();
-
-	ALuint source = GET_PTRID(chan->SysChannel);
-	SFXStatus *status = statusForSource(source);
+	upd->dirty |= SRCUPD_GAIN;
+	upd->gain = SfxVolume * volume;
+}
 
-	if (!status || status->state == AL_INITIAL) { return; }		// Sound is not yet playing on this source
+void OpenALSoundRenderer::ChannelPitch(FISoundChannel *chan, float pitch)
+{
+	OpenALSourceUpdate *upd = RecordSourceUpdate(chan);
+	if (upd == nullptr)
+		return;
 
-	alSourcef(source, AL_GAIN, SfxVolume * volume);
+	SFXStatus *s = statusForSource(upd->source);
+	upd->dirty |= SRCUPD_PITCH;
+	if (s->wasInWater && !(chan->ChanFlags & CHANF_UI))
+		upd->pitch = max(pitch, 0.0001f)*PITCH_MULT;
+	else
+		upd->pitch = max(pitch, 0.0001f);
 }
 
-void OpenALSoundRenderer::ChannelPitch(FISoundChannel *chan, float pitch)
+void OpenALSoundRenderer::ChannelOcclusion(FISoundChannel *chan, float gain, float gainhf)
 {
-	if (chan == NULL || chan->SysChannel == NULL)
+	if (OcclusionFilters.empty())
 		return;
 
-	//alDeferUpdatesSOFT();
+	OpenALSourceUpdate *upd = RecordSourceUpdate(chan);
+	if (upd == nullptr)
+		return;
 
-	ALuint source = GET_PTRID(chan->SysChannel);
-	SFXStatus *s = statusForSource(source);
+	// Sounds without reverb don't get the environment's filter either, so leave them dry.
+	SFXStatus *status = statusForSource(upd->source);
+	if (!status->canReverb)
+		return;
 
-	if (s && s->state != AL_INITIAL) {
-		if (s->wasInWater && !(chan->ChanFlags & CHANF_UI))
-			alSourcef(source, AL_PITCH, max(pitch, 0.0001f)*PITCH_MULT);
-		else
-			alSourcef(source, AL_PITCH, max(pitch, 0.0001f));
-	}
+	upd->dirty |= SRCUPD_OCCLUSION;
+	upd->occlGain = gain;
+	upd->occlHF = gainhf;
+	upd->waterHF = (WasInWater && *snd_waterreverb) ? 0.125f : 1.f;
+	upd->directFilter = EnvFilters[0];
 }
 
 void OpenALSoundRenderer::FlushPlayQueue() {
@@ -1784,6 +1986,183 @@ void OpenALSoundRenderer::FlushPlayQueue() {
 	}
 }
 
+//==========================================================================
+//
+// Batched source updates
+//
+// @Cockatrice - Position, velocity, gain and pitch changes only get recorded
+// on the main thread. SubmitUpdates hands them to the queue thread once per
+// frame, which applies them in a single deferred pass after starting any
+// queued sounds. Each update carries the serial of the play it was made for,
+// so nothing meant for a stopped sound ever reaches the next sound that gets
+// its source.
+//
+//==========================================================================
+
+OpenALSourceUpdate &OpenALUpdateBatch::Get(ALuint source, uint32_t serial)
+{
+	unsigned *index = SourceIndex.CheckKey(source);
+	if (index == nullptr)
+	{
+		unsigned i = Sources.Reserve(1);
+		SourceIndex.Insert(source, i);
+		auto &upd = Sources[i];
+		upd = {};
+		upd.source = source;
+		upd.serial = serial;
+		return upd;
+	}
+	auto &upd = Sources[*index];
+	if (upd.serial != serial)
+	{
+		upd = {};
+		upd.source = source;
+		upd.serial = serial;
+	}
+	return upd;
+}
+
+void OpenALUpdateBatch::Merge(const OpenALUpdateBatch &other)
+{
+	for (auto &src : other.Sources)
+	{
+		auto &upd = Get(src.source, src.serial);
+		if (src.dirty & SRCUPD_POSITION)
+		{
+			upd.relative = src.relative;
+			upd.pos = src.pos;
+		}
+		if (src.dirty & SRCUPD_VELOCITY) upd.vel = src.vel;
+		if (src.dirty & SRCUPD_REFDISTANCE) upd.refDistance = src.refDistance;
+		if (src.dirty & SRCUPD_GAIN) upd.gain = src.gain;
+		if (src.dirty & SRCUPD_MAXGAIN) upd.maxGain = src.maxGain;
+		if (src.dirty & SRCUPD_PITCH) upd.pitch = src.pitch;
+		if (src.dirty & SRCUPD_OCCLUSION)
+		{
+			upd.occlGain = src.occlGain;
+			upd.occlHF = src.occlHF;
+			upd.waterHF = src.waterHF;
+			upd.directFilter = src.directFilter;
+		}
+		upd.dirty |= src.dirty;
+	}
+	if (other.listenerDirty)
+	{
+		memcpy(listenerOrient, other.listenerOrient, sizeof(listenerOrient));
+		listenerPos = other.listenerPos;
+		listenerVel = other.listenerVel;
+		listenerDirty = true;
+	}
+}
+
+void OpenALUpdateBatch::Remove(ALuint source)
+{
+	unsigned *index = SourceIndex.CheckKey(source);
+	if (index == nullptr)
+		return;
+
+	unsigned i = *index, last = Sources.Size() - 1;
+	SourceIndex.Remove(source);
+	if (i != last)
+	{
+		Sources[i] = Sources[last];
+		SourceIndex[Sources[i].source] = i;
+	}
+	Sources.Pop();
+}
+
+OpenALSourceUpdate *OpenALSoundRenderer::RecordSourceUpdate(FISoundChannel *chan)
+{
+	if (chan == NULL || chan->SysChannel == NULL)
+		return nullptr;
+
+	ALuint source = GET_PTRID(chan->SysChannel);
+	SFXStatus *status = statusForSource(source);
+	if (!status)
+		return nullptr;
+
+	return &RecordBatch.Get(source, status->serial);
+}
+
+void OpenALSoundRenderer::SubmitUpdates()
+{
+	if (RecordBatch.IsEmpty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(UpdateLock);
+		// The queue thread may not have gotten to the last frame's updates yet.
+		if (PendingBatch.IsEmpty()) PendingBatch.Swap(RecordBatch);
+		else PendingBatch.Merge(RecordBatch);
+	}
+	RecordBatch.Clear();
+	QueueWake.notify_all();
+}
+
+void OpenALSoundRenderer::ApplyUpdates()
+{
+	// Held until everything is applied, so StopChannel can't hand the source to
+	// someone else while an update for the old sound is still on its way.
+	std::lock_guard<std::mutex> lock(UpdateLock);
+	if (PendingBatch.IsEmpty())
+		return;
+	ApplyBatch.Swap(PendingBatch);
+
+	alDeferUpdatesSOFT();
+
+	if (ApplyBatch.listenerDirty)
+	{
+		alListenerfv(AL_ORIENTATION, ApplyBatch.listenerOrient);
+		alListener3f(AL_POSITION, ApplyBatch.listenerPos.X, ApplyBatch.listenerPos.Y, ApplyBatch.listenerPos.Z);
+		alListener3f(AL_VELOCITY, ApplyBatch.listenerVel.X, ApplyBatch.listenerVel.Y, ApplyBatch.listenerVel.Z);
+	}
+
+	int applied = 0;
+	for (auto &upd : ApplyBatch.Sources)
+	{
+		auto played = PlayedSerials.find(upd.source);
+		if (played == PlayedSerials.end() || played->second != upd.serial)
+			continue;	// Not started yet or already replaced by another sound
+
+		ALuint source = upd.source;
+		if (upd.dirty & SRCUPD_POSITION)
+		{
+			alSourcei(source, AL_SOURCE_RELATIVE, upd.relative ? AL_TRUE : AL_FALSE);
+			alSource3f(source, AL_POSITION, upd.pos.X, upd.pos.Y, upd.pos.Z);
+		}
+		if (upd.dirty & SRCUPD_VELOCITY) alSource3f(source, AL_VELOCITY, upd.vel.X, upd.vel.Y, upd.vel.Z);
+		if (upd.dirty & SRCUPD_REFDISTANCE) alSourcef(source, AL_REFERENCE_DISTANCE, upd.refDistance);
+		if (upd.dirty & SRCUPD_MAXGAIN) alSourcef(source, AL_MAX_GAIN, upd.maxGain);
+		if (upd.dirty & SRCUPD_GAIN) alSourcef(source, AL_GAIN, upd.gain);
+		if (upd.dirty & SRCUPD_PITCH) alSourcef(source, AL_PITCH, upd.pitch);
+		if (upd.dirty & SRCUPD_OCCLUSION)
+		{
+			auto filter = OcclusionFilters.find(source);
+			if (filter != OcclusionFilters.end())
+			{
+				// The source copies the filter's settings when it is attached.
+				if (upd.occlGain >= 0.999f && upd.occlHF >= 0.999f)
+				{
+					alSourcei(source, AL_DIRECT_FILTER, upd.directFilter);
+				}
+				else
+				{
+					alFilterf(filter->second, AL_LOWPASS_GAIN, upd.occlGain);
+					alFilterf(filter->second, AL_LOWPASS_GAINHF, upd.occlHF * upd.waterHF);
+					alSourcei(source, AL_DIRECT_FILTER, filter->second);
+				}
+			}
+		}
+		applied++;
+	}
+
+	alProcessUpdatesSOFT();
+	getALError();
+
+	LastBatchSize = applied;
+	ApplyBatch.Clear();
+}
+
 void OpenALSoundRenderer::StopChannel(FISoundChannel *chan)
 {
 	if(chan == NULL || chan->SysChannel == NULL)
@@ -1830,6 +2209,15 @@ void OpenALSoundRenderer::StopChannel(FISoundChannel *chan)
 
 	SfxGroup.erase(source);
 
+	// Nothing recorded for this sound may reach whatever gets the source next,
+	// which can be a stream taking it right away.
+	RecordBatch.Remove(source);
+	{
+		std::lock_guard<std::mutex> lock(UpdateLock);
+		PendingBatch.Remove(source);
+		PlayedSerials.erase(source);
+	}
+
 	if (!(chan->ChanFlags & CHANF_EVICTED))
 		soundEngine->SoundDone(chan);
 
@@ -1979,17 +2367,15 @@ void OpenALSoundRenderer::UpdateSoundParams3D(SoundListener *listener, FISoundCh
 	float dist_sqr = (float)(pos - listener->position).LengthSquared();
 	chan->DistanceSqr = dist_sqr;
 
-	ALuint source = GET_PTRID(chan->SysChannel);
-	SFXStatus *status = statusForSource(source);
-
-	if (!status || status->state == AL_INITIAL) { return; }		// Sound is not yet playing on this source
-
-	//alDeferUpdatesSOFT();
+	OpenALSourceUpdate *upd = RecordSourceUpdate(chan);
+	if (upd == nullptr)
+		return;
 
+	upd->dirty |= SRCUPD_POSITION | SRCUPD_VELOCITY;
 	if(dist_sqr < (0.0004f*0.0004f))
 	{
-		alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
-		alSource3f(source, AL_POSITION, 0.f, 0.f, 0.f);
+		upd->relative = true;
+		upd->pos = { 0.f, 0.f, 0.f };
 	}
 	else
 	{
@@ -1997,14 +2383,14 @@ void OpenALSoundRenderer::UpdateSoundParams3D(SoundListener *listener, FISoundCh
 		{
 			float dist = sqrtf(dist_sqr);
 			float gain = GetRolloff(&chan->Rolloff, dist * chan->DistanceScale);
-			alSourcef(source, AL_REFERENCE_DISTANCE, max<float>(gain*dist, 0.0004f));
+			upd->dirty |= SRCUPD_REFDISTANCE;
+			upd->refDistance = max<float>(gain*dist, 0.0004f);
 		}
 
-		alSourcei(source, AL_SOURCE_RELATIVE, AL_FALSE);
-		alSource3f(source, AL_POSITION, pos[0], pos[1], -pos[2]);
+		upd->relative = false;
+		upd->pos = { pos[0], pos[1], -pos[2] };
 	}
-	alSource3f(source, AL_VELOCITY, vel[0], vel[1], -vel[2]);
-	getALError();
+	upd->vel = { vel[0], vel[1], -vel[2] };
 }
 
 void OpenALSoundRenderer::UpdateListener(SoundListener *listener)
@@ -2025,14 +2411,10 @@ void OpenALSoundRenderer::UpdateListener(SoundListener *listener)
 	orient[4] = 1.f;
 	orient[5] = 0.f;
 
-	alListenerfv(AL_ORIENTATION, orient);
-	alListener3f(AL_POSITION, listener->position.X,
-	                          listener->position.Y,
-	                         -listener->position.Z);
-	alListener3f(AL_VELOCITY, listener->velocity.X,
-	                          listener->velocity.Y,
-	                         -listener->velocity.Z);
-	getALError();
+	memcpy(RecordBatch.listenerOrient, orient, sizeof(orient));
+	RecordBatch.listenerPos = { listener->position.X, listener->position.Y, -listener->position.Z };
+	RecordBatch.listenerVel = { listener->velocity.X, listener->velocity.Y, -listener->velocity.Z };
+	RecordBatch.listenerDirty = true;
 
 	const ReverbContainer *env = ForcedEnvironment;
 	if(!env)
@@ -2051,6 +2433,7 @@ void OpenALSoundRenderer::UpdateListener(SoundListener *listener)
 
 		const_cast<ReverbContainer*>(env)->Modified = false;
 	}
+	UpdateReverbFade();
 
 	// NOTE: Moving into and out of water will undo pitch variations on sounds.
 	if(listener->underwater || env->SoftwareWater)
@@ -2082,8 +2465,7 @@ void OpenALSoundRenderer::UpdateListener(SoundListener *listener)
 							status->wasInWater = true;
 
 							if (status->state != AL_INITIAL) {
-								alSourcei(source, AL_DIRECT_FILTER, EnvFilters[0]);
-								alSource3i(source, AL_AUXILIARY_SEND_FILTER, EnvSlot, 0, EnvFilters[1]);
+								SetSourceSends(source, true);
 							}
 						}
 					}
@@ -2100,9 +2482,9 @@ void OpenALSoundRenderer::UpdateListener(SoundListener *listener)
 					if (status) {
 						status->wasInWater = true;
 
-						if (status->state != AL_INITIAL) {
-							alSourcef(source, AL_PITCH, schan->Pitch * PITCH_MULT);
-						}
+						OpenALSourceUpdate &upd = RecordBatch.Get(source, status->serial);
+						upd.dirty |= SRCUPD_PITCH;
+						upd.pitch = schan->Pitch * PITCH_MULT;
 					}
 				}
 					
@@ -2136,8 +2518,7 @@ void OpenALSoundRenderer::UpdateListener(SoundListener *listener)
 						status->wasInWater = false;
 
 						if (status->state != AL_INITIAL) {
-							alSourcei(source, AL_DIRECT_FILTER, EnvFilters[0]);
-							alSource3i(source, AL_AUXILIARY_SEND_FILTER, EnvSlot, 0, EnvFilters[1]);
+							SetSourceSends(source, true);
 						}
 					}
 				}
@@ -2155,9 +2536,9 @@ void OpenALSoundRenderer::UpdateListener(SoundListener *listener)
 				if (status) {
 					status->wasInWater = false;
 
-					if (status->state != AL_INITIAL) {
-						alSourcef(source, AL_PITCH, schan->Pitch);
-					}
+					OpenALSourceUpdate &upd = RecordBatch.Get(source, status->serial);
+					upd.dirty |= SRCUPD_PITCH;
+					upd.pitch = schan->Pitch;
 				}
 			}
 
@@ -2169,7 +2550,7 @@ void OpenALSoundRenderer::UpdateListener(SoundListener *listener)
 
 void OpenALSoundRenderer::UpdateSounds()
 {
-	alProcessUpdatesSOFT();
+	SubmitUpdates();
 
 	if(ALC.EXT_disconnect)
 	{
@@ -2268,11 +2649,33 @@ FString OpenALSoundRenderer::GatherStats()
 	uint32_t used = ((uint32_t)SfxGroup.size()) + Streams.Size();
 	uint32_t unused = FreeSfx.Size();
 
-	out.Format("%u sources (" TEXTCOLOR_YELLOW"%u" TEXTCOLOR_NORMAL" active, " TEXTCOLOR_YELLOW"%u" TEXTCOLOR_NORMAL" free), Update interval: " TEXTCOLOR_YELLOW"%.1f" TEXTCOLOR_NORMAL"ms",
-			   total, used, unused, 1000.f/static_cast<float>(refresh));
+	out.Format("%u sources (" TEXTCOLOR_YELLOW"%u" TEXTCOLOR_NORMAL" active, " TEXTCOLOR_YELLOW"%u" TEXTCOLOR_NORMAL" free), Update interval: " TEXTCOLOR_YELLOW"%.1f" TEXTCOLOR_NORMAL"ms, Last update batch: " TEXTCOLOR_YELLOW"%d" TEXTCOLOR_NORMAL" sources",
+			   total, used, unused, 1000.f/static_cast<float>(refresh), LastBatchSize.load());
+	if(EnvSlot)
+		out.AppendFormat("\nReverb: " TEXTCOLOR_YELLOW"%u" TEXTCOLOR_NORMAL" effects cached, " TEXTCOLOR_YELLOW"%u" TEXTCOLOR_NORMAL" slot attaches, %s",
+			   EnvEffects.CountUsed(), ReverbAttaches, EnvFadeSlot ? "crossfading" : "single slot");
 	return out;
 }
 
+FString OpenALSoundRenderer::GatherStreamStats()
+{
+	FString out;
+	std::unique_lock<std::mutex> lock(StreamLock);
+	out.Format("%u streams, read-ahead " TEXTCOLOR_YELLOW"%d" TEXTCOLOR_NORMAL"ms", Streams.Size(), *snd_streamreadahead);
+	for (unsigned i = 0; i < Streams.Size(); i++)
+	{
+		out.AppendFormat("\n  %u: %s", i, Streams[i]->GetRingStats().GetChars());
+	}
+	return out;
+}
+
+ADD_STAT(streams)
+{
+	auto renderer = dynamic_cast<OpenALSoundRenderer *>(GSnd);
+	if (renderer == nullptr) return "No OpenAL streams";
+	return renderer->GatherStreamStats();
+}
+
 void OpenALSoundRenderer::PrintDriversList()
 {
 	const ALCchar *drivers = (alcIsExtensionPresent(NULL, "ALC_ENUMERATE_ALL_EXT") ?
@@ -2358,7 +2761,14 @@ void OpenALSoundRenderer::PurgeStoppedSources()
 	}
 }
 
-void OpenALSoundRenderer::LoadReverb(const ReverbContainer *env)
+//==========================================================================
+//
+// Returns the effect for an environment, creating it or uploading changed
+// parameters first if needed. Clears env->Modified.
+//
+//==========================================================================
+
+ALuint OpenALSoundRenderer::GetEnvEffect(const ReverbContainer *env)
 {
 	ALuint *envReverb = EnvEffects.CheckKey(env->ID);
 	bool doLoad = (env->Modified || !envReverb);
@@ -2459,11 +2869,123 @@ void OpenALSoundRenderer::LoadReverb(const ReverbContainer *env)
 		}
 #undef mB2Gain
 	}
+	const_cast<ReverbContainer*>(env)->Modified = false;
+	getALError();
+	return *envReverb;
+}
+
+//==========================================================================
+//
+// Switches the listener to an environment.
+//
+// @Cockatrice - With two sends every reverb source feeds both EnvSlot and
+// EnvFadeSlot, so switching only attaches the new effect to the slot that
+// is fading out and lets UpdateReverbFade move the gains across. Going
+// back to the environment that is still attached to the other slot, which
+// is what walking back and forth over a zone boundary does, attaches
+// nothing at all.
+//
+//==========================================================================
+
+void OpenALSoundRenderer::LoadReverb(const ReverbContainer *env)
+{
+	bool modified = env->Modified;
+	ALuint effect = GetEnvEffect(env);
+
+	if(!EnvFadeSlot)
+	{
+		alAuxiliaryEffectSloti(EnvSlot, AL_EFFECTSLOT_EFFECT, effect);
+		ReverbAttaches++;
+		getALError();
+		return;
+	}
 
-	alAuxiliaryEffectSloti(EnvSlot, AL_EFFECTSLOT_EFFECT, *envReverb);
+	const ALuint slots[2] = { EnvSlot, EnvFadeSlot };
+	int slot = ActiveEnvSlot;
+	if(EnvSlotEffect[slot] != effect)
+	{
+		slot ^= 1;
+		if(EnvSlotEffect[slot] != effect)
+		{
+			// Only reached with a third environment while the last fade is still going.
+			// Cut the old tail instead of letting it jump to the new effect's sound.
+			EnvSlotGain[slot] = 0.f;
+			alAuxiliaryEffectSlotf(slots[slot], AL_EFFECTSLOT_GAIN, 0.f);
+			modified = true;
+		}
+	}
+	if(modified)
+	{
+		// Slots copy the effect's parameters when it gets attached.
+		alAuxiliaryEffectSloti(slots[slot], AL_EFFECTSLOT_EFFECT, effect);
+		EnvSlotEffect[slot] = effect;
+		ReverbAttaches++;
+	}
+	ActiveEnvSlot = slot;
 	getALError();
 }
 
+//==========================================================================
+//
+// Moves the slot gains towards the active environment, once per frame.
+//
+//==========================================================================
+
+void OpenALSoundRenderer::UpdateReverbFade()
+{
+	using namespace std::chrono;
+
+	uint64_t now = duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+	float step = (LastReverbFade > 0 && snd_reverbfade > 0) ? (now - LastReverbFade) / float(*snd_reverbfade) : 1.f;
+	LastReverbFade = now;
+
+	if(!EnvFadeSlot)
+		return;
+
+	const ALuint slots[2] = { EnvSlot, EnvFadeSlot };
+	for(int i = 0; i < 2; i++)
+	{
+		float target = (i == ActiveEnvSlot) ? 1.f : 0.f;
+		float gain = EnvSlotGain[i];
+		if(gain < target) gain = std::min(gain + step, target);
+		else if(gain > target) gain = std::max(gain - step, target);
+		if(gain != EnvSlotGain[i])
+		{
+			EnvSlotGain[i] = gain;
+			alAuxiliaryEffectSlotf(slots[i], AL_EFFECTSLOT_GAIN, gain);
+		}
+	}
+	getALError();
+}
+
+//==========================================================================
+//
+// Creates the effects for a level's environments while it is loading,
+// so entering a zone never has to.
+//
+//==========================================================================
+
+void OpenALSoundRenderer::PrecacheEnvironment(const ReverbContainer *env)
+{
+	if(EnvSlot != 0 && env != nullptr && !EnvEffects.CheckKey(env->ID))
+		GetEnvEffect(env);
+}
+
+//==========================================================================
+//
+// Routes a source into the environment's reverb, through both slots when
+// there are two sends.
+//
+//==========================================================================
+
+void OpenALSoundRenderer::SetSourceSends(ALuint source, bool reverb)
+{
+	alSourcei(source, AL_DIRECT_FILTER, reverb ? EnvFilters[0] : AL_FILTER_NULL);
+	alSource3i(source, AL_AUXILIARY_SEND_FILTER, reverb ? EnvSlot : 0, 0, reverb ? EnvFilters[1] : AL_FILTER_NULL);
+	if(EnvFadeSlot)
+		alSource3i(source, AL_AUXILIARY_SEND_FILTER, reverb ? EnvFadeSlot : 0, 1, reverb ? EnvFilters[1] : AL_FILTER_NULL);
+}
+
 FSoundChan *OpenALSoundRenderer::FindLowestChannel()
 {
 	FSoundChan *schan = soundEngine->GetChannels();
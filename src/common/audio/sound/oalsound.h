@@ -39,6 +39,60 @@ struct OpenALQueueItem {
 	ALuint envSlot = 0;
 	bool reuseChan = false;		// Only used to signal what type of offset startTime is
 	bool inWater = false;		// Play as if in water
+	uint32_t serial = 0;		// Identifies this play of the source for OpenALSourceUpdate
+};
+
+// @Cockatrice - Per-frame source parameter changes are recorded on the main thread
+// and applied by the queue thread in one deferred pass. Only the last value of
+// each parameter per source is kept.
+enum
+{
+	SRCUPD_POSITION = 1,	// AL_SOURCE_RELATIVE and AL_POSITION
+	SRCUPD_VELOCITY = 2,
+	SRCUPD_REFDISTANCE = 4,
+	SRCUPD_GAIN = 8,
+	SRCUPD_MAXGAIN = 16,
+	SRCUPD_PITCH = 32,
+	SRCUPD_OCCLUSION = 64,	// Lowpass on the direct path
+};
+
+struct OpenALSourceUpdate {
+	ALuint source = 0;
+	uint32_t serial = 0;		// Updates for an older play of the source are dropped
+	int dirty = 0;
+	bool relative = false;
+	FVector3 pos = { 0.,0.,0. }, vel = { 0.,0.,0. };
+	float refDistance = 0, gain = 0, maxGain = 0, pitch = 0;
+	float occlGain = 1, occlHF = 1, waterHF = 1;
+	ALuint directFilter = 0;	// Restored when the occlusion goes away
+};
+
+struct OpenALUpdateBatch {
+	TArray<OpenALSourceUpdate> Sources;
+	TMap<ALuint, unsigned> SourceIndex;
+	bool listenerDirty = false;
+	ALfloat listenerOrient[6] = {};
+	FVector3 listenerPos = { 0.,0.,0. }, listenerVel = { 0.,0.,0. };
+
+	OpenALSourceUpdate &Get(ALuint source, uint32_t serial);
+	void Merge(const OpenALUpdateBatch &other);
+	void Remove(ALuint source);
+	bool IsEmpty() const { return Sources.Size() == 0 && !listenerDirty; }
+	void Swap(OpenALUpdateBatch &other)
+	{
+		Sources.Swap(other.Sources);
+		SourceIndex.Swap(other.SourceIndex);
+		std::swap(listenerDirty, other.listenerDirty);
+		std::swap(listenerOrient, other.listenerOrient);
+		std::swap(listenerPos, other.listenerPos);
+		std::swap(listenerVel, other.listenerVel);
+	}
+	void Clear()
+	{
+		Sources.Clear();
+		SourceIndex.Clear();
+		listenerDirty = false;
+	}
 };
 
 struct OpenALPlayedItem {
@@ -63,6 +117,7 @@ public:
 	virtual void UnloadSound(SoundHandle sfx);
 	virtual unsigned int GetMSLength(SoundHandle sfx);
 	virtual unsigned int GetSampleLength(SoundHandle sfx);
+	virtual unsigned int GetSampleRate(SoundHandle sfx);
 	virtual float GetOutputRate();
 
 	// Streaming sounds.
@@ -79,6 +134,8 @@ public:
 	// Changes a channel's pitch.
 	virtual void ChannelPitch(FISoundChannel *chan, float pitch);
 
+	void ChannelOcclusion(FISoundChannel *chan, float gain, float gainhf) override;
+
 	// Stops a sound channel.
 	virtual void StopChannel(FISoundChannel *chan);
 
@@ -98,6 +155,7 @@ public:
 	virtual void UpdateSoundParams3D(SoundListener *listener, FISoundChannel *chan, bool areasound, const FVector3 &pos, const FVector3 &vel);
 
 	virtual void UpdateListener(SoundListener *);
+	void PrecacheEnvironment(const ReverbContainer *env) override;
 	virtual void UpdateSounds();
 
 	virtual void MarkStartTime(FISoundChannel*, float startTime);
@@ -108,6 +166,7 @@ public:
 	virtual void PrintStatus();
 	virtual void PrintDriversList();
 	virtual FString GatherStats();
+	FString GatherStreamStats();
 
 private:
     struct {
@@ -179,19 +238,27 @@ private:
 
     void BackgroundProc();
 	void BackgroundQueueProc();
+	void DecodeProc();
 	void FlushPlayQueue();
 	void UpdatePlayedSounds();
+	OpenALSourceUpdate *RecordSourceUpdate(FISoundChannel *chan);
+	void SubmitUpdates();
+	void ApplyUpdates();
     void AddStream(OpenALSoundStream *stream);
     void RemoveStream(OpenALSoundStream *stream);
 
 	void LoadReverb(const ReverbContainer *env);
+	ALuint GetEnvEffect(const ReverbContainer *env);
+	void UpdateReverbFade();
+	void SetSourceSends(ALuint source, bool reverb);
 	void PurgeStoppedSources();
 	static FSoundChan *FindLowestChannel();
 
-    std::thread StreamThread, QueueThread;
+    std::thread StreamThread, QueueThread, DecodeThread;
 	std::mutex StreamLock, QueueThreadLock;
-    std::condition_variable StreamWake, QueueWake;
-    std::atomic<bool> QuitThread, QuitQueueThread;
+	std::mutex DecodeLock;						// Taken after StreamLock, never the other way around
+    std::condition_variable StreamWake, QueueWake, DecodeWake;
+    std::atomic<bool> QuitThread, QuitQueueThread, QuitDecodeThread;
 
 	ALCdevice *Device;
 	ALCcontext *Context;
@@ -205,6 +272,7 @@ private:
 		ALuint source = 0;
 		ALint state = AL_INITIAL;
 		bool canReverb, canPause, wasInWater;
+		uint32_t serial = 0;
 	};
 
 	std::atomic<int> SFXPaused;
@@ -224,7 +292,14 @@ private:
     typedef TMap<uint16_t,ALuint> EffectMap;
     typedef TMapIterator<uint16_t,ALuint> EffectMapIter;
     ALuint EnvSlot;
+    ALuint EnvFadeSlot;							// Crossfade partner of EnvSlot, 0 if sources only have one send
     ALuint EnvFilters[2];
+	ALuint EnvSlotEffect[2] = {};				// Effect attached to EnvSlot and EnvFadeSlot
+	float EnvSlotGain[2] = { 1.f, 0.f };
+	int ActiveEnvSlot = 0;
+	uint64_t LastReverbFade = 0;
+	unsigned ReverbAttaches = 0;
+	std::unordered_map<ALuint, ALuint> OcclusionFilters;	// One lowpass per source, never changes after init
     EffectMap EnvEffects;
 
     bool WasInWater;
@@ -232,6 +307,13 @@ private:
     TArray<OpenALSoundStream*> Streams;
 	TSQueue<OpenALQueueItem> PlayQueue;			// Fill PlayQueue to play, once played appears in PlayedQueue
 	TSQueue<OpenALPlayedItem> PlayedQueue;
+
+	uint32_t PlaySerial = 0;
+	OpenALUpdateBatch RecordBatch;				// Main thread only
+	OpenALUpdateBatch PendingBatch, ApplyBatch;	// PendingBatch is guarded by UpdateLock, ApplyBatch belongs to the queue thread
+	std::unordered_map<ALuint, uint32_t> PlayedSerials;	// The play each source is currently running, guarded by UpdateLock
+	std::mutex UpdateLock;
+	std::atomic<int> LastBatchSize;
 	
 	friend class OpenALSoundStream;
 
@@ -20,13 +20,15 @@ static void AppendAudioThreadStats(int q, int l, double tt, FString &out)
 		"Avg Load Time: %2.3f +(%2.3f)\n"
 		"Min Load Time: %2.3f +(%2.3f)\n"
 		"Max Load Time: %2.3f +(%2.3f)\n"
-		"Update Time: %2.3f\n",
+		"Update Time: %2.3f\n"
+		"PCM Cache: %d memory hits, %d disk hits, %d decoded, %2.1f MB\n",
 		q, 
 		l, AudioLoaderQueue::Instance->getTotalLoaded(), AudioLoaderQueue::Instance->getTotalFailed(),
 		AudioLoaderQueue::Instance->calcLoadAvg(), AudioLoaderQueue::Instance->calcAvgIntegration(),
 		AudioLoaderQueue::Instance->calcMinLoad(), AudioLoaderQueue::Instance->calcMinIntegration(),
 		AudioLoaderQueue::Instance->calcMaxLoad(), AudioLoaderQueue::Instance->calcMaxIntegration(),
-		tt
+		tt,
+		PCMCacheStats[PCMCACHE_MEMHITS].load(), PCMCacheStats[PCMCACHE_DISKHITS].load(), PCMCacheStats[PCMCACHE_DECODED].load(), PCMCacheStats[PCMCACHE_BYTES].load() / 1048576.
 	);
 }
 
@@ -113,7 +115,7 @@ bool AudioLoadThread::loadResource(AudioQInput &input, AudioQOutput &output) {
 		// If that fails, let the sound system try and figure it out.
 		else
 		{
-			output.loadedSnd = GSnd->LoadSound((uint8_t *)data, size, input.sfx->LoopStart, input.sfx->LoopEnd);
+			output.loadedSnd = S_LoadSoundCached((uint8_t *)data, size, input.sfx->LoopStart, input.sfx->LoopEnd);
 		}
 
 		if (output.loadedSnd.isValid()) {
@@ -141,10 +143,11 @@ AudioLoaderQueue::~AudioLoaderQueue() {
 	clear();
 }
 
-AudioLoadThread *AudioLoaderQueue::spinupThreads() {
-	if ((int)mRunning.Size() >= audio_loader_threads) return nullptr;
+AudioLoadThread *AudioLoaderQueue::spinupThreads(int count) {
+	const int wanted = max((int)audio_loader_threads, count);
+	if ((int)mRunning.Size() >= wanted) return nullptr;
 
-	int createThreads = clamp((int)(audio_loader_threads - mRunning.Size()), 0, MAX_THREADS);
+	int createThreads = clamp((int)(wanted - mRunning.Size()), 0, MAX_THREADS - (int)mRunning.Size());
 	AudioLoadThread *first = nullptr;
 
 	for (int x = 0; x < createThreads; x++) {
@@ -211,6 +214,11 @@ void AudioLoaderQueue::queue(sfxinfo_t *sfx, FSoundID soundID, const AudioQueueP
 		if (!th) {
 			th = spinupThreads();
 		}
+		// Every thread is busy with a backlog, add one while we are allowed to
+		else if (minQ >= THREAD_QUEUE_DEPTH && (int)mRunning.Size() < MAX_THREADS) {
+			AudioLoadThread *nt = spinupThreads((int)mRunning.Size() + 1);
+			if (nt) th = nt;
+		}
 
 		if (th) {
 			AudioQInput qInput;
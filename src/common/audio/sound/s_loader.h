@@ -10,6 +10,19 @@
 #include "stats.h"
 #include "TSQueue.h"
 
+// Decoded PCM cache, see s_pcmcache.cpp
+enum
+{
+	PCMCACHE_MEMHITS,
+	PCMCACHE_DISKHITS,
+	PCMCACHE_DECODED,
+	PCMCACHE_BYTES,
+	PCMCACHE_NUMSTATS
+};
+
+extern std::atomic<int> PCMCacheStats[PCMCACHE_NUMSTATS];
+SoundHandle S_LoadSoundCached(uint8_t *sfxdata, int length, int def_loop_start, int def_loop_end);
+
 // This should encapsulate pre-calculated data on how the sound will be played
 // After it finishes loading via the queue
 struct AudioQueuePlayInfo {
@@ -100,10 +113,11 @@ private:
 
 	bool relinkSound(AudioQueuePlayInfo &item, FSoundID sndID, int sourcetype, const void *from, const void *to, const FVector3 *optpos);
 	
-	AudioLoadThread *spinupThreads();	// Start as many threads as necessary or specified, return the first one
+	AudioLoadThread *spinupThreads(int count = 0);	// Start as many threads as necessary or specified, return the first one
 
 public:
 	static const int MAX_THREADS = 4;	// Max number of threads that will be allowed to be running at once, regardless of CVAR value
+	static const int THREAD_QUEUE_DEPTH = 8;	// Another thread is started when every running one has this many sounds queued
 	
 	AudioLoaderQueue();
 	~AudioLoaderQueue();
@@ -0,0 +1,400 @@
+/*
+** s_pcmcache.cpp
+** Decoded PCM cache for compressed sound effects
+**
+** OGG, FLAC and MP3 sounds used to be decoded again by the sound backend
+** each time they got loaded, which happens after every level change.
+** Their decoded samples are now kept in a size bounded in-memory LRU and
+** in the user's cache directory, keyed by a checksum of the lump data,
+** so later loads only need to create the sound buffer. The disk cache is
+** size bounded as well, the oldest files are removed first.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+*/
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <zlib.h>
+#include <zmusic.h>
+#include "s_loader.h"
+#include "i_sound.h"
+#include "c_cvars.h"
+#include "cmdlib.h"
+#include "m_fixed.h"
+#include "i_specialpaths.h"
+#include "fs_files.h"
+#include "fs_findfile.h"
+#include "printf.h"
+
+CVAR(Int, snd_pcmcache_size, 64, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)		// in MB
+CVAR(Bool, snd_pcmcache_disk, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+CVAR(Int, snd_pcmcache_disksize, 256, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)	// in MB
+
+enum
+{
+	PCMCACHE_VERSION = 1,
+	PCMCACHE_HEADER = 48,
+	PCMCACHE_MINDISK = 32768,		// Decoding less than this is about as fast as opening the file.
+};
+
+struct FDecodedSound
+{
+	int SourceLength;
+	int DefLoopStart, DefLoopEnd;	// The caller's loop points, the cached ones depend on them
+	int Frequency, Channels, Bits;
+	int LoopStart, LoopEnd;			// In samples, -1 if none
+	TArray<uint8_t> Samples;
+};
+
+struct FPCMCacheEntry
+{
+	std::shared_ptr<FDecodedSound> Sound;
+	uint64_t LastUse;
+};
+
+static std::mutex PCMCacheLock;
+static TMap<uint64_t, FPCMCacheEntry> PCMCache;
+static size_t PCMCacheBytes;
+static uint64_t PCMCacheUse;
+
+static std::mutex PCMDiskLock;
+static TMap<uint64_t, bool> PCMDiskWrites;		// Keys a loader thread is writing right now
+static int64_t PCMDiskBytes = -1;				// -1 until the directory has been scanned
+static std::atomic<unsigned> PCMDiskTemp;
+
+std::atomic<int> PCMCacheStats[PCMCACHE_NUMSTATS];
+
+//==========================================================================
+//
+// Decodes a sound like OpenALSoundRenderer::LoadSound does, but keeps the
+// samples instead of buffering them right away.
+//
+//==========================================================================
+
+static std::shared_ptr<FDecodedSound> DecodeSound(const uint8_t *sfxdata, int length, int def_loop_start, int def_loop_end)
+{
+	uint32_t loop_start = 0, loop_end = ~0u;
+	zmusic_bool startass = false, endass = false;
+
+	if (def_loop_start < 0)
+	{
+		FindLoopTags(sfxdata, length, &loop_start, &startass, &loop_end, &endass);
+	}
+	else
+	{
+		loop_start = def_loop_start;
+		loop_end = def_loop_end;
+		startass = endass = true;
+	}
+
+	auto decoder = CreateDecoder(sfxdata, length, true);
+	if (decoder == nullptr) return nullptr;
+
+	ChannelConfig chans;
+	SampleType type;
+	int srate;
+	SoundDecoder_GetInfo(decoder, &srate, &chans, &type);
+
+	auto snd = std::make_shared<FDecodedSound>();
+	snd->Channels = chans == ChannelConfig_Mono ? 1 : chans == ChannelConfig_Stereo ? 2 : 0;
+	snd->Bits = type == SampleType_UInt8 ? 8 : type == SampleType_Int16 ? 16 : 0;
+	if (snd->Channels == 0 || snd->Bits == 0 || srate <= 0)
+	{
+		// Let the backend deal with it and print its error.
+		SoundDecoder_Close(decoder);
+		return nullptr;
+	}
+
+	auto &data = snd->Samples;
+	unsigned total = 0, got;
+	data.Resize(32768);
+	while ((got = (unsigned)SoundDecoder_Read(decoder, &data[total], data.Size() - total)) > 0)
+	{
+		total += got;
+		if (total == data.Size()) data.Resize(total * 2);
+	}
+	SoundDecoder_Close(decoder);
+	if (total == 0) return nullptr;
+	data.Resize(total);
+
+	const uint32_t samples = total / (snd->Channels * snd->Bits / 8);
+	if (!startass) loop_start = Scale(loop_start, srate, 1000);
+	if (!endass && loop_end != ~0u) loop_end = Scale(loop_end, srate, 1000);
+	if (loop_start > samples) loop_start = 0;
+	if (loop_end > samples) loop_end = samples;
+
+	snd->SourceLength = length;
+	snd->DefLoopStart = def_loop_start;
+	snd->DefLoopEnd = def_loop_end;
+	snd->Frequency = srate;
+	snd->LoopStart = snd->LoopEnd = -1;
+	if ((loop_start > 0 || loop_end > 0) && loop_end > loop_start)
+	{
+		snd->LoopStart = loop_start;
+		snd->LoopEnd = loop_end;
+	}
+	return snd;
+}
+
+//==========================================================================
+//
+// Disk cache
+//
+//==========================================================================
+
+static FString PCMCachePath(uint64_t key, bool create)
+{
+	FString path = M_GetCachePath(create);
+	path << "/pcm";
+	if (create) CreatePath(path.GetChars());
+	path.AppendFormat("/%016llx.pcm", (unsigned long long)key);
+	return path;
+}
+
+static uint32_t ReadPCMLong(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (uint32_t(p[3]) << 24);
+}
+
+static void WritePCMLong(uint8_t *p, uint32_t v)
+{
+	p[0] = uint8_t(v);
+	p[1] = uint8_t(v >> 8);
+	p[2] = uint8_t(v >> 16);
+	p[3] = uint8_t(v >> 24);
+}
+
+static std::shared_ptr<FDecodedSound> ReadCachedPCM(uint64_t key, int length, int def_loop_start, int def_loop_end)
+{
+	FileReader fr;
+	if (!fr.OpenFile(PCMCachePath(key, false).GetChars())) return nullptr;
+
+	uint8_t header[PCMCACHE_HEADER];
+	if (fr.Read(header, PCMCACHE_HEADER) != PCMCACHE_HEADER) return nullptr;
+	if (memcmp(header, "PCMC", 4) || ReadPCMLong(header + 4) != PCMCACHE_VERSION) return nullptr;
+	if ((int)ReadPCMLong(header + 8) != length || (int)ReadPCMLong(header + 12) != def_loop_start || (int)ReadPCMLong(header + 16) != def_loop_end) return nullptr;
+
+	auto snd = std::make_shared<FDecodedSound>();
+	snd->SourceLength = length;
+	snd->DefLoopStart = def_loop_start;
+	snd->DefLoopEnd = def_loop_end;
+	snd->Frequency = ReadPCMLong(header + 20);
+	snd->Channels = ReadPCMLong(header + 24);
+	snd->Bits = ReadPCMLong(header + 28);
+	snd->LoopStart = ReadPCMLong(header + 32);
+	snd->LoopEnd = ReadPCMLong(header + 36);
+	uint32_t size = ReadPCMLong(header + 40);
+	uint32_t crc = ReadPCMLong(header + 44);
+
+	if (size == 0 || (snd->Channels != 1 && snd->Channels != 2) || (snd->Bits != 8 && snd->Bits != 16)) return nullptr;
+	snd->Samples.Resize(size);
+	if (fr.Read(snd->Samples.Data(), size) != size || crc32(0, snd->Samples.Data(), size) != crc)
+	{
+		DPrintf(DMSG_WARNING, "Decoded sound cache %016llx is damaged\n", (unsigned long long)key);
+		return nullptr;
+	}
+	return snd;
+}
+
+//==========================================================================
+//
+// Scans the disk cache and removes the oldest files until it is back
+// under 3/4 of the limit, so this doesn't run again for every new sound.
+// Leftover temp files from an interrupted write are counted as well.
+// Must be called with PCMDiskLock held.
+//
+//==========================================================================
+
+static void TrimCachedPCM(size_t limit)
+{
+	struct FCachedFile
+	{
+		std::string Path;
+		size_t Size;
+		time_t Time;
+	};
+
+	FString dir = M_GetCachePath(false);
+	dir << "/pcm/";
+
+	FileSys::FileList list;
+	std::vector<FCachedFile> files;
+	size_t total = 0;
+	if (!FileSys::ScanDirectory(list, dir.GetChars(), "*", true)) return;
+
+	for (auto &entry : list)
+	{
+		FCachedFile file = { entry.FilePath, 0, 0 };
+		if (entry.isDirectory || !GetFileInfo(file.Path.c_str(), &file.Size, &file.Time)) continue;
+		total += file.Size;
+		files.push_back(std::move(file));
+	}
+
+	if (total > limit)
+	{
+		std::sort(files.begin(), files.end(), [](const FCachedFile &a, const FCachedFile &b) { return a.Time < b.Time; });
+		for (auto &file : files)
+		{
+			if (total <= limit / 4 * 3) break;
+			RemoveFile(file.Path.c_str());
+			total -= file.Size;
+		}
+	}
+	PCMDiskBytes = total;
+}
+
+static void WriteCachedPCM(uint64_t key, const FDecodedSound &snd)
+{
+	{
+		// Two loader threads can decode the same sound at once. Only one of them gets to write it.
+		std::lock_guard<std::mutex> lock(PCMDiskLock);
+		if (PCMDiskWrites.CheckKey(key)) return;
+		PCMDiskWrites[key] = true;
+	}
+
+	uint8_t header[PCMCACHE_HEADER];
+	memcpy(header, "PCMC", 4);
+	WritePCMLong(header + 4, PCMCACHE_VERSION);
+	WritePCMLong(header + 8, snd.SourceLength);
+	WritePCMLong(header + 12, snd.DefLoopStart);
+	WritePCMLong(header + 16, snd.DefLoopEnd);
+	WritePCMLong(header + 20, snd.Frequency);
+	WritePCMLong(header + 24, snd.Channels);
+	WritePCMLong(header + 28, snd.Bits);
+	WritePCMLong(header + 32, snd.LoopStart);
+	WritePCMLong(header + 36, snd.LoopEnd);
+	WritePCMLong(header + 40, snd.Samples.Size());
+	WritePCMLong(header + 44, crc32(0, snd.Samples.Data(), snd.Samples.Size()));
+
+	// Write to a temp file and move it into place, so a reader never sees a partial file.
+	FString path = PCMCachePath(key, true);
+	FString temp;
+	temp.Format("%s.%u.tmp", path.GetChars(), PCMDiskTemp++);
+
+	bool ok = false;
+	FileWriter *fw = FileWriter::Open(temp.GetChars());
+	if (fw != nullptr)
+	{
+		ok = fw->Write(header, PCMCACHE_HEADER) == PCMCACHE_HEADER && fw->Write(snd.Samples.Data(), snd.Samples.Size()) == snd.Samples.Size();
+		delete fw;
+		// Don't leave a truncated file behind, it would be rejected on every load.
+		if (!ok || !RenameFile(temp.GetChars(), path.GetChars()))
+		{
+			RemoveFile(temp.GetChars());
+			ok = false;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(PCMDiskLock);
+	PCMDiskWrites.Remove(key);
+	if (ok)
+	{
+		const size_t limit = size_t(max(0, (int)snd_pcmcache_disksize)) << 20;
+		if (PCMDiskBytes >= 0) PCMDiskBytes += PCMCACHE_HEADER + snd.Samples.Size();
+		if (PCMDiskBytes < 0 || size_t(PCMDiskBytes) > limit) TrimCachedPCM(limit);
+	}
+}
+
+//==========================================================================
+//
+// Memory cache
+//
+//==========================================================================
+
+static std::shared_ptr<FDecodedSound> FindCachedPCM(uint64_t key, int length, int def_loop_start, int def_loop_end)
+{
+	std::lock_guard<std::mutex> lock(PCMCacheLock);
+	auto entry = PCMCache.CheckKey(key);
+	if (entry == nullptr) return nullptr;
+
+	auto &snd = *entry->Sound;
+	if (snd.SourceLength != length || snd.DefLoopStart != def_loop_start || snd.DefLoopEnd != def_loop_end) return nullptr;
+	entry->LastUse = ++PCMCacheUse;
+	return entry->Sound;
+}
+
+static void StoreCachedPCM(uint64_t key, std::shared_ptr<FDecodedSound> snd)
+{
+	const size_t limit = size_t(max(0, (int)snd_pcmcache_size)) << 20;
+	if (snd->Samples.Size() > limit / 4) return;	// A few huge sounds shouldn't flush everything else.
+
+	std::lock_guard<std::mutex> lock(PCMCacheLock);
+	if (auto old = PCMCache.CheckKey(key))
+	{
+		PCMCacheBytes -= old->Sound->Samples.Size();
+	}
+	PCMCacheBytes += snd->Samples.Size();
+	PCMCache[key] = { std::move(snd), ++PCMCacheUse };
+
+	// Evict the least recently used sounds. They are still on disk.
+	while (PCMCacheBytes > limit)
+	{
+		uint64_t oldestkey = 0, oldest = UINT64_MAX;
+		TMap<uint64_t, FPCMCacheEntry>::Iterator it(PCMCache);
+		TMap<uint64_t, FPCMCacheEntry>::Pair *pair;
+		while (it.NextPair(pair))
+		{
+			if (pair->Value.LastUse < oldest)
+			{
+				oldest = pair->Value.LastUse;
+				oldestkey = pair->Key;
+			}
+		}
+		PCMCacheBytes -= PCMCache[oldestkey].Sound->Samples.Size();
+		PCMCache.Remove(oldestkey);
+	}
+	PCMCacheStats[PCMCACHE_BYTES] = (int)PCMCacheBytes;
+}
+
+//==========================================================================
+//
+// S_LoadSoundCached
+//
+// Drop-in replacement for GSnd->LoadSound. Thread safe, so it can be
+// used by the loader threads.
+//
+//==========================================================================
+
+SoundHandle S_LoadSoundCached(uint8_t *sfxdata, int length, int def_loop_start, int def_loop_end)
+{
+	// WAV data only needs to be copied, there is nothing to gain.
+	if (snd_pcmcache_size <= 0 || length < 12 || !memcmp(sfxdata, "RIFF", 4))
+	{
+		return GSnd->LoadSound(sfxdata, length, def_loop_start, def_loop_end);
+	}
+
+	const uint64_t key = (uint64_t(crc32(0, sfxdata, length)) << 32) | uint32_t(length);
+
+	auto snd = FindCachedPCM(key, length, def_loop_start, def_loop_end);
+	if (snd != nullptr)
+	{
+		PCMCacheStats[PCMCACHE_MEMHITS]++;
+	}
+	else
+	{
+		if (snd_pcmcache_disk) snd = ReadCachedPCM(key, length, def_loop_start, def_loop_end);
+		if (snd != nullptr)
+		{
+			PCMCacheStats[PCMCACHE_DISKHITS]++;
+		}
+		else
+		{
+			snd = DecodeSound(sfxdata, length, def_loop_start, def_loop_end);
+			if (snd == nullptr) return GSnd->LoadSound(sfxdata, length, def_loop_start, def_loop_end);
+
+			PCMCacheStats[PCMCACHE_DECODED]++;
+			if (snd_pcmcache_disk && snd_pcmcache_disksize > 0 && snd->Samples.Size() >= PCMCACHE_MINDISK) WriteCachedPCM(key, *snd);
+		}
+		StoreCachedPCM(key, snd);
+	}
+
+	// LoadSoundRaw only modifies the data for signed 8 bit input, which never gets here.
+	return GSnd->LoadSoundRaw(snd->Samples.Data(), snd->Samples.Size(), snd->Frequency, snd->Channels, snd->Bits, snd->LoopStart, snd->LoopEnd);
+}
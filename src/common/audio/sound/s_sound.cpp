@@ -35,6 +35,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 
 
 #include "s_soundinternal.h"
@@ -57,6 +58,9 @@ CVAR(Bool, i_pauseinbackground, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 CVAR(Bool, snd_pitched, false, CVAR_ARCHIVE)
 
 CVAR(Bool, snd_evict_lists, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
+// @Cockatrice - Only the most important 3D sounds get a real voice, the others keep their place and time without one
+CVARD(Bool, snd_virtualvoices, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG, "plays only the most audible sounds on real voices, the rest are tracked silently")
+CVARD(Int, snd_audiblevoices, 64, CVAR_ARCHIVE | CVAR_GLOBALCONFIG, "number of sounds that get a real voice with snd_virtualvoices")
 
 int SoundEnabled()
 {
@@ -1053,13 +1057,13 @@ void SoundEngine::RestartChannel(FSoundChan *chan)
 			return;
 		}
 
-		chan->ChanFlags &= ~(CHANF_EVICTED|CHANF_ABSTIME);
+		chan->ChanFlags &= ~(CHANF_EVICTED|CHANF_ABSTIME|CHANF_CULLED);
         ochan = (FSoundChan*)GSnd->StartSound3D(sfx->data, &listener, chan->Volume, &chan->Rolloff, chan->DistanceScale, chan->Pitch,
             chan->Priority, pos, vel, chan->EntChannel, startflags, chan);
 	}
 	else
 	{
-		chan->ChanFlags &= ~(CHANF_EVICTED|CHANF_ABSTIME);
+		chan->ChanFlags &= ~(CHANF_EVICTED|CHANF_ABSTIME|CHANF_CULLED);
 		ochan = (FSoundChan*)GSnd->StartSound(sfx->data, chan->Volume, chan->Pitch, startflags, chan);
 	}
 	assert(ochan == NULL || ochan == chan);
@@ -1169,7 +1173,7 @@ sfxinfo_t *SoundEngine::LoadSound(sfxinfo_t *sfx)
 			// If that fails, let the sound system try and figure it out.
 			else
 			{
-				sfx->data = GSnd->LoadSound(sfxp, size, sfx->LoopStart, sfx->LoopEnd);
+				sfx->data = S_LoadSoundCached(sfxp, size, sfx->LoopStart, sfx->LoopEnd);
 			}
 		}
 
@@ -1678,7 +1682,8 @@ void SoundEngine::RestoreEvictedChannel(FSoundChan *chan)
 		return;
 	}
 	RestoreEvictedChannel(chan->NextChan);
-	if (chan->ChanFlags & CHANF_EVICTED)
+	// Culled channels are brought back by UpdateVoices once they are audible again.
+	if ((chan->ChanFlags & CHANF_EVICTED) && !((chan->ChanFlags & CHANF_CULLED) && snd_virtualvoices))
 	{
 		RestartChannel(chan);
 		if (!(chan->ChanFlags & CHANF_LOOP))
@@ -1714,6 +1719,152 @@ void SoundEngine::RestoreEvictedChannels()
 	RestoreEvictedChannel(Channels);
 }
 
+//==========================================================================
+//
+// Virtual voices
+//
+// @Cockatrice - With many 3D sounds going at once only the snd_audiblevoices
+// most important ones keep a real voice. The others are culled: they are
+// evicted like EvictAllChannels does it, but keep advancing their sample
+// offset so they can be restarted at the right place once they are
+// audible again. Culled channels only cost a CalcPosVel per update and
+// never get close to the backend's voice limit, so its hard evictions
+// that drop sounds are rare.
+//
+//==========================================================================
+
+EXTERN_CVAR(Int, snd_channels)
+
+static constexpr float VOICE_MINGAIN = 1.f / 1024;	// Quieter than this counts as inaudible (-60 dB)
+
+struct FVoiceRank
+{
+	FSoundChan *Chan;
+	FVector3 Pos, Vel;
+	float Gain;
+	bool Valid;
+	bool JustStarted;
+};
+
+static TArray<FVoiceRank> VoiceRanks;
+
+float SoundEngine::GetVoiceGain(const FSoundChan *chan, const FVector3 &pos)
+{
+	float dist = (pos - listener.position).Length() * chan->DistanceScale;
+	return chan->Volume * GetRolloff(&chan->Rolloff, dist);
+}
+
+void SoundEngine::CullChannel(FSoundChan *chan)
+{
+	chan->StartTime = GSnd->GetPosition(chan);
+	// Only ask the backend once, AdvanceCulledChannel runs for every culled channel on every update.
+	auto sfx = &S_sfx[chan->SoundID.index()];
+	chan->CulledLength = sfx->data.isValid() ? GSnd->GetSampleLength(sfx->data) : 0;
+	chan->CulledRate = sfx->data.isValid() ? GSnd->GetSampleRate(sfx->data) : 0;
+	// A forgettable channel would be returned by StopChannel.
+	chan->ChanFlags = (chan->ChanFlags & ~CHANF_FORGETTABLE) | CHANF_EVICTED | CHANF_ABSTIME | CHANF_CULLED;
+	StopChannel(chan);
+}
+
+//==========================================================================
+//
+// Moves a culled channel's sample offset forward by the given time.
+// Returns false if a sound that doesn't loop has ended in the meantime.
+//
+//==========================================================================
+
+bool SoundEngine::AdvanceCulledChannel(FSoundChan *chan, double seconds)
+{
+	if (seconds <= 0 || chan->CulledRate == 0) return true;
+
+	const unsigned int len = chan->CulledLength;
+	if (len == 0) return !!(chan->ChanFlags & CHANF_LOOP);
+
+	uint64_t pos = chan->StartTime + uint64_t(seconds * chan->CulledRate * std::max(chan->Pitch, 0.0001f));
+	if (pos >= len)
+	{
+		if (!(chan->ChanFlags & CHANF_LOOP)) return false;
+		pos %= len;
+	}
+	chan->StartTime = pos;
+	return true;
+}
+
+//==========================================================================
+//
+// S_UpdateVoices
+//
+// Ranks the playing and culled 3D channels like the backend picks the
+// channel to evict, by priority first and then by how loud they are at the
+// listener. Channels ranked within the budget play, the others get culled.
+// Playing channels are only culled past a small margin and culled ones need
+// twice the minimum gain to come back, so channels near the cut-off don't
+// keep restarting.
+//
+//==========================================================================
+
+void SoundEngine::UpdateVoices(int num2d, bool canrestart)
+{
+	uint64_t now = I_nsTime();
+	double seconds = LastVoiceUpdate > 0 ? (now - LastVoiceUpdate) * 1e-9 : 0;
+	LastVoiceUpdate = now;
+
+	std::stable_sort(VoiceRanks.begin(), VoiceRanks.end(), [](const FVoiceRank &a, const FVoiceRank &b)
+	{
+		bool audiblea = a.Gain >= VOICE_MINGAIN, audibleb = b.Gain >= VOICE_MINGAIN;
+		if (audiblea != audibleb) return audiblea;
+		if (a.Chan->Priority != b.Chan->Priority) return a.Chan->Priority > b.Chan->Priority;
+		return a.Gain > b.Gain;
+	});
+
+	const int budget = std::max(0, std::min<int>(snd_audiblevoices, snd_channels) - num2d);
+	const int margin = budget / 8;
+	AudibleVoices = num2d;
+	CulledVoices = 0;
+
+	for (unsigned i = 0; i < VoiceRanks.Size(); i++)
+	{
+		auto &rank = VoiceRanks[i];
+		auto chan = rank.Chan;
+
+		if (!(chan->ChanFlags & CHANF_EVICTED))
+		{
+			// Channels that haven't started yet don't have a position to restart from.
+			if (rank.JustStarted || chan->SysChannel == nullptr || ((int)i < budget + margin && rank.Gain >= VOICE_MINGAIN))
+			{
+				if (rank.Valid)
+				{
+					GSnd->UpdateSoundParams3D(&listener, chan, !!(chan->ChanFlags & CHANF_AREA), rank.Pos, rank.Vel);
+				}
+				AudibleVoices++;
+			}
+			else
+			{
+				CullChannel(chan);
+				CulledVoices++;
+			}
+			continue;
+		}
+
+		// Like playing channels, culled ones stand still while sound is paused.
+		if (!SoundPaused || (chan->ChanFlags & (CHANF_UI | CHANF_NOPAUSE)))
+		{
+			if (!AdvanceCulledChannel(chan, seconds))
+			{
+				ReturnChannel(chan);
+				continue;
+			}
+		}
+		if (canrestart && rank.Valid && (int)i < budget && rank.Gain >= VOICE_MINGAIN * 2)
+		{
+			RestartChannel(chan);
+		}
+		if (chan->ChanFlags & CHANF_EVICTED) CulledVoices++;
+		else AudibleVoices++;
+	}
+	VoiceRanks.Clear();
+}
+
 //==========================================================================
 //
 // S_UpdateSounds
@@ -1726,11 +1877,24 @@ void SoundEngine::UpdateSounds(int time)
 	FVector3 pos, vel;
 	FSoundChan* purges[5] = { NULL, NULL, NULL, NULL, NULL };
 	int purgeCnt = 0;
+	int num2d = 0;
+	const bool virtualize = snd_virtualvoices && listener.valid;
 
+	VoiceRanks.Clear();
 	for (FSoundChan* chan = Channels; chan != NULL; chan = chan->NextChan)
 	{
 		const bool reserved = (chan->ChanFlags & CHANF_RESERVED) != 0;
-		if ((chan->ChanFlags & (CHANF_EVICTED | CHANF_IS3D)) == CHANF_IS3D && !reserved)
+		if (virtualize && !reserved && (chan->ChanFlags & CHANF_IS3D) && (chan->ChanFlags & (CHANF_EVICTED | CHANF_CULLED)) != CHANF_EVICTED)
+		{
+			// Playing and culled 3D channels are ranked, UpdateVoices does the rest.
+			auto &rank = VoiceRanks[VoiceRanks.Reserve(1)];
+			rank.Chan = chan;
+			rank.JustStarted = !!(chan->ChanFlags & CHANF_JUSTSTARTED);
+			CalcPosVel(chan, &rank.Pos, &rank.Vel);
+			rank.Valid = ValidatePosVel(chan, rank.Pos, rank.Vel);
+			rank.Gain = rank.Valid ? GetVoiceGain(chan, rank.Pos) : 0.f;
+		}
+		else if ((chan->ChanFlags & (CHANF_EVICTED | CHANF_IS3D)) == CHANF_IS3D && !reserved)
 		{
 			CalcPosVel(chan, &pos, &vel);
 
@@ -1739,6 +1903,10 @@ void SoundEngine::UpdateSounds(int time)
 				GSnd->UpdateSoundParams3D(&listener, chan, !!(chan->ChanFlags & CHANF_AREA), pos, vel);
 			}
 		}
+		else if (!(chan->ChanFlags & (CHANF_EVICTED | CHANF_IS3D)) && !reserved)
+		{
+			num2d++;
+		}
 
 		if (!reserved) {
 			chan->ChanFlags &= ~CHANF_JUSTSTARTED;
@@ -1765,6 +1933,16 @@ void SoundEngine::UpdateSounds(int time)
 		}
 	}
 
+	if (virtualize)
+	{
+		UpdateVoices(num2d, time >= RestartEvictionsAt);
+	}
+	else
+	{
+		LastVoiceUpdate = 0;
+		AudibleVoices = CulledVoices = 0;
+	}
+
 	GSnd->UpdateListener(&listener);
 	GSnd->UpdateSounds();
 
@@ -2377,4 +2555,11 @@ ADD_STAT(sound)
 	return GSnd->GatherStats();
 }
 
+ADD_STAT(voices)
+{
+	int audible, culled;
+	soundEngine->GetVoiceCounts(audible, culled);
+	return FStringf("%d audible, %d virtual, budget %d%s", audible, culled, *snd_audiblevoices, snd_virtualvoices ? "" : " (off)");
+}
+
 
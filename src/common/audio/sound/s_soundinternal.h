@@ -165,6 +165,8 @@ struct FSoundChan : public FISoundChannel
 	float		LimitRange;
 	const void *Source;
 	float Point[3];	// Sound is not attached to any source.
+	unsigned int CulledLength;	// @Cockatrice - Sample count and rate of the sound, looked up once when the channel is culled
+	unsigned int CulledRate;
 };
 
 
@@ -221,6 +223,8 @@ class SoundEngine
 protected:
 	bool SoundPaused = false;		// whether sound is paused
 	int RestartEvictionsAt = 0;		// do not restart evicted channels before this time
+	uint64_t LastVoiceUpdate = 0;	// @Cockatrice - I_nsTime of the last virtual voice update
+	int AudibleVoices = 0, CulledVoices = 0;
 	SoundListener listener{};
 
 	FSoundChan* Channels = nullptr;
@@ -241,6 +245,10 @@ private:
 	void ReturnChannel(FSoundChan* chan);
 	void RestartChannel(FSoundChan* chan);
 	void RestoreEvictedChannel(FSoundChan* chan);
+	void UpdateVoices(int num2d, bool canrestart);
+	float GetVoiceGain(const FSoundChan* chan, const FVector3& pos);
+	void CullChannel(FSoundChan* chan);
+	bool AdvanceCulledChannel(FSoundChan* chan, double seconds);
 
 	bool IsChannelUsed(int sourcetype, const void* actor, int channel, int* seen);
 	// This is the actual sound positioning logic which needs to be provided by the client.
@@ -264,6 +272,11 @@ public:
 		Shutdown();
 	}
 	void EvictAllChannels();
+	void GetVoiceCounts(int& audible, int& culled) const
+	{
+		audible = AudibleVoices;
+		culled = CulledVoices;
+	}
 
 	void BlockNewSounds(bool on)
 	{
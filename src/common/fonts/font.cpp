@@ -1247,4 +1247,5 @@ void FFont::FixXMoves()
 void FFont::ClearOffsets()
 {
 	for (auto& c : Chars) if (c.OriginalPic) c.OriginalPic->SetOffsets(0, 0);
+	for (auto& c : AtlasChars) if (c.tAtlas) c.tLeft = c.tTop = 0;
 }
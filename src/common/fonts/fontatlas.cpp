@@ -0,0 +1,217 @@
+/*
+** fontatlas.cpp
+** Packs a font's glyphs into a few shared atlas pages.
+**
+** Fonts that are not read from sheets have a separate texture for each
+** glyph, so every character of a string ends up as its own 2D draw command
+** and texture bind. The first time such a font is drawn its glyphs are
+** packed into one or more composite pages and the text drawer then uses
+** sub-rectangles of those, just like it does for sheet fonts, so a string
+** (and usually a whole screen of text in the same font) becomes one batch.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+*/
+
+#include <algorithm>
+#include "v_font.h"
+#include "c_cvars.h"
+#include "printf.h"
+#include "textures.h"
+#include "image.h"
+#include "multipatchtexture.h"
+#include "texturemanager.h"
+
+CVAR(Bool, r_fontatlas, true, CVAR_ARCHIVE)
+
+enum
+{
+	ATLAS_MINSIZE = 128,
+	ATLAS_MAXSIZE = 1024,
+	ATLAS_MAXPAGES = 4,		// Huge fonts (e.g. the hex font) only get their first glyphs packed
+	ATLAS_PADDING = 2,		// Keeps filtering and upscaling from bleeding between neighbours
+};
+
+struct FAtlasGlyph
+{
+	FGameTexture *Pic;
+	FImageTexture *Image;
+	int Width, Height;
+	int X, Y, Page;
+};
+
+//==========================================================================
+//
+// Shelf packer. Glyphs come sorted by height, so each shelf is as tall as
+// its first glyph. Returns the number of glyphs that were placed and the
+// height actually used.
+//
+//==========================================================================
+
+static unsigned PackAtlasPage(TArray<FAtlasGlyph *> &glyphs, unsigned start, int page, int width, int height, int *usedheight)
+{
+	int x = ATLAS_PADDING, y = ATLAS_PADDING, shelf = 0;
+	unsigned i;
+
+	for (i = start; i < glyphs.Size(); i++)
+	{
+		auto g = glyphs[i];
+		if (x + g->Width + ATLAS_PADDING > width)
+		{
+			x = ATLAS_PADDING;
+			y += shelf + ATLAS_PADDING;
+			shelf = 0;
+		}
+		if (y + g->Height + ATLAS_PADDING > height) break;
+
+		g->X = x;
+		g->Y = y;
+		g->Page = page;
+		x += g->Width + ATLAS_PADDING;
+		shelf = std::max(shelf, g->Height);
+	}
+	*usedheight = y + shelf + ATLAS_PADDING;
+	return i;
+}
+
+//==========================================================================
+//
+// FFont :: BuildAtlas
+//
+//==========================================================================
+
+void FFont::BuildAtlas()
+{
+	if (AtlasChecked) return;
+	AtlasChecked = true;
+
+	// Sheet fonts already draw from one texture.
+	if (supportsChardata || Chars.Size() == 0) return;
+
+	TArray<FAtlasGlyph> glyphs;
+	TMap<FGameTexture *, unsigned> glyphmap;
+	float scalex = 0, scaley = 0;
+
+	for (auto &c : Chars)
+	{
+		auto pic = c.OriginalPic;
+		if (pic == nullptr || glyphmap.CheckKey(pic)) continue;
+
+		auto image = dynamic_cast<FImageTexture *>(pic->GetTexture());
+		if (image == nullptr || image->GetImage() == nullptr) continue;
+
+		// A page has one scale, glyphs that don't match it are drawn on their own.
+		if (scalex == 0)
+		{
+			scalex = pic->GetScaleX();
+			scaley = pic->GetScaleY();
+		}
+		else if (pic->GetScaleX() != scalex || pic->GetScaleY() != scaley) continue;
+
+		int w = pic->GetTexelWidth(), h = pic->GetTexelHeight();
+		if (w <= 0 || h <= 0 || w + ATLAS_PADDING * 2 > ATLAS_MAXSIZE || h + ATLAS_PADDING * 2 > ATLAS_MAXSIZE) continue;
+
+		glyphmap.Insert(pic, glyphs.Push({ pic, image, w, h, 0, 0, -1 }));
+	}
+	if (glyphs.Size() < 2) return;
+
+	TArray<FAtlasGlyph *> order(glyphs.Size(), true);
+	for (unsigned i = 0; i < glyphs.Size(); i++) order[i] = &glyphs[i];
+	std::stable_sort(order.begin(), order.end(), [](const FAtlasGlyph *a, const FAtlasGlyph *b) { return a->Height > b->Height; });
+
+	// Use the smallest single page everything fits on, otherwise fill full size pages.
+	TArray<int> pagewidths, pageheights;
+	int used;
+	for (int size = ATLAS_MINSIZE; size <= ATLAS_MAXSIZE; size <<= 1)
+	{
+		if (PackAtlasPage(order, 0, 0, size, size, &used) == order.Size())
+		{
+			pagewidths.Push(size);
+			pageheights.Push(used);
+			break;
+		}
+	}
+	if (pagewidths.Size() == 0)
+	{
+		unsigned start = 0;
+		while (start < order.Size() && pagewidths.Size() < ATLAS_MAXPAGES)
+		{
+			unsigned next = PackAtlasPage(order, start, pagewidths.Size(), ATLAS_MAXSIZE, ATLAS_MAXSIZE, &used);
+			if (next == start) break;
+			pagewidths.Push(ATLAS_MAXSIZE);
+			pageheights.Push(used);
+			start = next;
+		}
+		for (; start < order.Size(); start++) order[start]->Page = -1;
+	}
+
+	TArray<FGameTexture *> pages;
+	for (unsigned p = 0; p < pagewidths.Size(); p++)
+	{
+		int height = ATLAS_MINSIZE / 8;
+		while (height < pageheights[p]) height <<= 1;
+
+		TArray<TexPartBuild> parts;
+		for (auto &g : glyphs)
+		{
+			if (g.Page != (int)p) continue;
+			auto &part = parts[parts.Reserve(1)];
+			part.TexImage = g.Image;
+			part.OriginX = g.X;
+			part.OriginY = g.Y;
+		}
+
+		auto image = new FMultiPatchTexture(pagewidths[p], height, parts, false, false);
+		auto gtex = MakeGameTexture(new FImageTexture(image), nullptr, ETextureType::FontChar);
+		gtex->SetScale(scalex, scaley);
+		TexMan.AddGameTexture(gtex);
+		pages.Push(gtex);
+	}
+
+	AtlasChars = Chars;
+	for (auto &c : AtlasChars)
+	{
+		if (c.OriginalPic == nullptr) continue;
+		auto index = glyphmap.CheckKey(c.OriginalPic);
+		if (index == nullptr || glyphs[*index].Page < 0) continue;
+
+		auto &g = glyphs[*index];
+		c.tLeft = g.Pic->GetDisplayLeftOffset();
+		c.tTop = g.Pic->GetDisplayTopOffset();
+		c.OriginalPic = pages[g.Page];
+		c.tCharX = g.X;
+		c.tCharY = g.Y;
+		c.tCharW = g.Width;
+		c.tCharH = g.Height;
+		c.tAtlas = true;
+	}
+	unsigned packed = 0;
+	for (auto &g : glyphs) if (g.Page >= 0) packed++;
+	DPrintf(DMSG_SPAMMY, "Font %s: packed %u of %u glyphs into %u atlas pages\n", FontName.GetChars(), packed, glyphs.Size(), pages.Size());
+}
+
+//==========================================================================
+//
+// FFont :: GetAtlasChar
+//
+// Same as GetChar, but returns the glyph's location on an atlas page
+// if it has one.
+//
+//==========================================================================
+
+FFont::CharData FFont::GetAtlasChar(int code, int translation) const
+{
+	if (AtlasChars.Size() == 0) return GetChar(code, translation);
+
+	code = GetCharCode(code, true);
+	if (code < 0)
+	{
+		CharData data;
+		data.XMove = SpaceWidth;
+		return data;
+	}
+	return AtlasChars[code - FirstChar];
+}
@@ -104,6 +104,8 @@ public:
 		FGameTexture* OriginalPic = nullptr;
 		int XMove = INT_MIN;
 		int tCharX = -1, tCharY = -1, tCharW = -1, tCharH = -1;
+		double tLeft = 0, tTop = 0;		// @Cockatrice - Original glyph offsets when drawing from an atlas page
+		bool tAtlas = false;
 	};
 
 	FFont (const char *fontname, const char *nametemplate, const char *filetemplate, int first, int count, int base, int fdlump, int spacewidth=-1, bool notranslate = false, bool iwadonly = false, bool doomtemplate = false, GlyphSet *baseGlpyphs = nullptr);
@@ -112,6 +114,8 @@ public:
 
 	virtual FGameTexture *GetChar (int code, int translation, int *const width) const;
 	virtual CharData GetChar(int code, int translation) const;
+	CharData GetAtlasChar(int code, int translation) const;
+	void BuildAtlas();
 
 	virtual int GetCharWidth (int code) const;
 	FTranslationID GetColorTranslation (EColorRange range, PalEntry *color = nullptr) const;
@@ -179,6 +183,8 @@ public:
 		Translations = other.Translations;
 		lowercaselatinonly = other.lowercaselatinonly;
 		Lump = other.Lump;
+		AtlasChars.Reset();
+		AtlasChecked = false;
 	}
 
 protected:
@@ -205,6 +211,8 @@ protected:
 	bool lowercaselatinonly = false;
 
 	TArray<CharData> Chars;
+	TArray<CharData> AtlasChars;	// @Cockatrice - Same layout as Chars, but pointing into the shared atlas pages
+	bool AtlasChecked = false;
 	TArray<FTranslationID> Translations;
 
 	int Lump;
@@ -81,8 +81,50 @@ void FModel::DestroyVertexBuffer()
 	loadState = NONE;
 }
 
-void FModel::LoadGeometry(FileSys::FileData* lumpData) {
-	I_FatalError("LoadGeometry(FileData) is not implemented for: %s\n", mFileName.GetChars());
+//===========================================================================
+//
+// Reads a lump through a private file reader so this is safe
+// to call from the background loader threads
+//
+//===========================================================================
+
+FileSys::FileData FModel::ReadGeometryLump(int lump)
+{
+	FileReader reader = fileSystem.OpenFileReader(lump, FileSys::EReaderType::READER_NEW, 0);
+	auto data = reader.Read();
+	reader.Close();
+	return data;
+}
+
+//===========================================================================
+//
+// Copies the packed geometry into a new vertex buffer.
+// This is the only part of model loading that has to be synchronous.
+//
+//===========================================================================
+
+void FModel::UploadStagedGeometry(FModelRenderer* renderer, bool needindex, bool singleframe)
+{
+	auto vbuf = renderer->CreateVertexBuffer(needindex, singleframe);
+	SetVertexBuffer(renderer->GetType(), vbuf);
+
+	FModelVertex* vertptr = vbuf->LockVertexBuffer(mStagedVertices.Size());
+	if (mStagedVertices.Size() > 0)
+		memcpy(vertptr, mStagedVertices.Data(), mStagedVertices.Size() * sizeof(FModelVertex));
+	vbuf->UnlockVertexBuffer();
+
+	if (needindex)
+	{
+		unsigned int* indxptr = vbuf->LockIndexBuffer(mStagedIndices.Size());
+		if (mStagedIndices.Size() > 0)
+			memcpy(indxptr, mStagedIndices.Data(), mStagedIndices.Size() * sizeof(unsigned int));
+		vbuf->UnlockIndexBuffer();
+	}
+
+	// The GPU has its copy now
+	mStagedVertices.Reset();
+	mStagedIndices.Reset();
+	mStaged = false;
 }
 
 //===========================================================================
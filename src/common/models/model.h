@@ -101,7 +101,8 @@ public:
 	virtual void AddSkins(uint8_t *hitlist, const FTextureID* surfaceskinids) = 0;
 	virtual float getAspectFactor(float vscale) { return 1.f; }
 	virtual const TArray<TRS>* AttachAnimationData() { return nullptr; };
-	virtual const TArray<VSMatrix> CalculateBones(int frame1, int frame2, float inter, int frame1_prev, float inter1_prev, int frame2_prev, float inter2_prev, const TArray<TRS>* animationData, DBoneComponents* bones, int index) { return {}; };
+	// Writes the evaluated bone matrices into the caller supplied array, which is expected to be reused between calls
+	virtual void CalculateBones(int frame1, int frame2, float inter, int frame1_prev, float inter1_prev, int frame2_prev, float inter2_prev, const TArray<TRS>* animationData, DBoneComponents* bones, int index, TArray<VSMatrix>& boneData) { boneData.Clear(); };
 
 	void SetVertexBuffer(int type, IModelVertexBuffer *buffer) { mVBuf[type] = buffer; }
 	IModelVertexBuffer *GetVertexBuffer(int type) const { return mVBuf[type]; }
@@ -110,7 +111,12 @@ public:
 	LoadState GetLoadState() const { return loadState; }
 	void SetLoadState(LoadState state) { loadState = state; }
 
-	virtual void LoadGeometry(FileSys::FileData* lumpData);
+	// @Cockatrice - Parses the model geometry and packs it into the staging arrays.
+	// Must not touch anything but the model itself, this is called from the model loader threads.
+	// BuildVertexBuffer() will do the same on the main thread if the model was not loaded in the background
+	virtual bool PackGeometry() { return false; }
+	virtual bool SupportsBackgroundLoad() const { return false; }
+	bool HasStagedGeometry() const { return mStaged; }
 	int GetLumpNum() const { return mLumpNum; }
 
 	bool hasSurfaces = false;
@@ -124,6 +130,14 @@ private:
 	LoadState loadState = NONE;
 protected:
 	int mLumpNum = -1;
+
+	// Packed vertex and index data waiting to be copied into the renderer's buffers
+	TArray<FModelVertex> mStagedVertices;
+	TArray<unsigned int> mStagedIndices;
+	bool mStaged = false;
+
+	void UploadStagedGeometry(FModelRenderer* renderer, bool needindex, bool singleframe);
+	static FileSys::FileData ReadGeometryLump(int lump);
 };
 
 int ModelFrameHash(FSpriteModelFrame* smf);
@@ -103,6 +103,25 @@ struct IQMBounds
 	float Radius;
 };
 
+// @Cockatrice - Evaluated pose, shared by every instance that requests the same frame pair and interpolation.
+// The animation data pointer is only a valid key together with the generation it was stored in, see IQMModel::AnimationGeneration.
+struct IQMPoseCacheEntry
+{
+	const TArray<TRS>* AnimationData = nullptr;
+	uint32_t Generation = 0;
+	int Frame1 = -1, Frame2 = -1, Frame1Prev = -1, Frame2Prev = -1;
+	float Inter = 0, Inter1Prev = 0, Inter2Prev = 0;
+	uint32_t LastUsed = 0;
+	TArray<TRS> Components;
+	TArray<VSMatrix> Matrices;
+
+	bool Matches(uint32_t generation, const TArray<TRS>* animationData, int frame1, int frame2, float inter, int frame1_prev, float inter1_prev, int frame2_prev, float inter2_prev) const
+	{
+		return Generation == generation && AnimationData == animationData && Frame1 == frame1 && Frame2 == frame2 && Inter == inter &&
+			Frame1Prev == frame1_prev && Inter1Prev == inter1_prev && Frame2Prev == frame2_prev && Inter2Prev == inter2_prev;
+	}
+};
+
 class IQMFileReader;
 
 class IQMModel : public FModel
@@ -117,13 +136,15 @@ public:
 	int FindLastFrame(FName name) override;
 	double FindFramerate(FName name) override;
 	void RenderFrame(FModelRenderer* renderer, FGameTexture* skin, int frame, int frame2, double inter, FTranslationID translation, const FTextureID* surfaceskinids, const TArray<VSMatrix>& boneData, int boneStartPosition) override;
+	bool PackGeometry() override;
+	bool SupportsBackgroundLoad() const override { return true; }
 	void BuildVertexBuffer(FModelRenderer* renderer) override;
 	void AddSkins(uint8_t* hitlist, const FTextureID* surfaceskinids) override;
 	const TArray<TRS>* AttachAnimationData() override;
-	const TArray<VSMatrix> CalculateBones(int frame1, int frame2, float inter, int frame1_prev, float inter1_prev, int frame2_prev, float inter2_prev, const TArray<TRS>* animationData, DBoneComponents* bones, int index) override;
+	void CalculateBones(int frame1, int frame2, float inter, int frame1_prev, float inter1_prev, int frame2_prev, float inter2_prev, const TArray<TRS>* animationData, DBoneComponents* bones, int index, TArray<VSMatrix>& boneData) override;
 
 private:
-	void LoadGeometry();
+	bool LoadGeometry();
 	void UnloadGeometry();
 
 	void LoadPosition(IQMFileReader& reader, const IQMVertexArray& vertexArray);
@@ -132,8 +153,6 @@ private:
 	void LoadBlendIndexes(IQMFileReader& reader, const IQMVertexArray& vertexArray);
 	void LoadBlendWeights(IQMFileReader& reader, const IQMVertexArray& vertexArray);
 
-	int mLumpNum = -1;
-
 	TMap<FName, int> NamedAnimations;
 
 	TArray<IQMMesh> Meshes;
@@ -145,12 +164,25 @@ private:
 	TArray<IQMBounds> Bounds;
 	TArray<IQMVertexArray> VertexArrays;
 	uint32_t NumVertices = 0;
+	bool BadGeometry = false;
 
 	TArray<FModelVertex> Vertices;
 
 	TArray<VSMatrix> baseframe;
 	TArray<VSMatrix> inversebaseframe;
 	TArray<TRS> TRSData;
+
+	// Per joint constants folded out of CalculateBones: swapYZ * baseframe[parent] and inversebaseframe[joint] * swapYZ
+	TArray<VSMatrix> bonePreTransform;
+	TArray<VSMatrix> bonePostTransform;
+
+	static const int PoseCacheSize = 16;
+	IQMPoseCacheEntry PoseCache[PoseCacheSize];
+	uint32_t PoseCacheCounter = 0;
+
+	// Bumped whenever an IQM model is destroyed, so that a new model's animation data
+	// allocated at the same address can never match a pose cached for the old one.
+	static uint32_t AnimationGeneration;
 };
 
 struct IQMReadErrorException { };
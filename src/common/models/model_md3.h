@@ -68,7 +68,9 @@ public:
 	virtual bool Load(const char * fn, int lumpnum, const char * buffer, int length) override;
 	virtual int FindFrame(const char* name, bool nodefault) override;
 	virtual void RenderFrame(FModelRenderer *renderer, FGameTexture * skin, int frame, int frame2, double inter, FTranslationID translation, const FTextureID* surfaceskinids, const TArray<VSMatrix>& boneData, int boneStartPosition) override;
-	void LoadGeometry(FileSys::FileData *lumpData) override;
+	void LoadGeometry(FileSys::FileData *lumpData);
+	bool PackGeometry() override;
+	bool SupportsBackgroundLoad() const override { return true; }
 	void BuildVertexBuffer(FModelRenderer *renderer);
 	virtual void AddSkins(uint8_t *hitlist, const FTextureID* surfaceskinids) override;
 };
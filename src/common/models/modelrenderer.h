@@ -25,5 +25,8 @@ public:
 	virtual void DrawArrays(int start, int count) = 0;
 	virtual void DrawElements(int numIndices, size_t offset) = 0;
 	virtual int SetupFrame(FModel* model, unsigned int frame1, unsigned int frame2, unsigned int size, const TArray<VSMatrix>& bones, int boneStartIndex) { return -1; };
+
+	// Scratch space for bone evaluation, reused between models so that it doesn't allocate per instance.
+	TArray<VSMatrix> BoneData;
 };
 
@@ -11,12 +11,15 @@
 IMPLEMENT_CLASS(DBoneComponents, false, false);
 
 
+uint32_t IQMModel::AnimationGeneration = 1;
+
 IQMModel::IQMModel()
 {
 }
 
 IQMModel::~IQMModel()
 {
+	AnimationGeneration++;
 }
 
 bool IQMModel::Load(const char* path, int lumpnum, const char* buffer, int length)
@@ -176,6 +179,26 @@ bool IQMModel::Load(const char* path, int lumpnum, const char* buffer, int lengt
 			}			
 		}
 
+		// Fold the constant parts of the bone chain so CalculateBones only has to do the animated ones
+		float swapYZ[16] = { 0.0f };
+		swapYZ[0 + 0 * 4] = 1.0f;
+		swapYZ[1 + 2 * 4] = 1.0f;
+		swapYZ[2 + 1 * 4] = 1.0f;
+		swapYZ[3 + 3 * 4] = 1.0f;
+
+		bonePreTransform.Resize(num_joints);
+		bonePostTransform.Resize(num_joints);
+
+		for (uint32_t i = 0; i < num_joints; i++)
+		{
+			bonePreTransform[i].loadMatrix(swapYZ);
+			if (Joints[i].Parent >= 0)
+				bonePreTransform[i].multMatrix(baseframe[Joints[i].Parent]);
+
+			bonePostTransform[i] = inversebaseframe[i];
+			bonePostTransform[i].multMatrix(swapYZ);
+		}
+
 		TRSData.Resize(num_frames * num_poses);
 		reader.SeekTo(ofs_frames);
 		for (uint32_t i = 0; i < num_frames; i++)
@@ -269,11 +292,11 @@ bool IQMModel::Load(const char* path, int lumpnum, const char* buffer, int lengt
 	}
 }
 
-void IQMModel::LoadGeometry()
+bool IQMModel::LoadGeometry()
 {
 	try
 	{
-		auto lumpdata = fileSystem.ReadFile(mLumpNum);
+		auto lumpdata = ReadGeometryLump(mLumpNum);
 		IQMFileReader reader(lumpdata.data(), (int)lumpdata.size());
 
 		Vertices.Resize(NumVertices);
@@ -301,9 +324,11 @@ void IQMModel::LoadGeometry()
 				LoadBlendWeights(reader, vertexArray);
 			}
 		}
+		return true;
 	}
 	catch (IQMReadErrorException)
 	{
+		return false;
 	}
 }
 
@@ -471,6 +496,10 @@ double IQMModel::FindFramerate(FName name)
 
 void IQMModel::RenderFrame(FModelRenderer* renderer, FGameTexture* skin, int frame1, int frame2, double inter, FTranslationID translation, const FTextureID* surfaceskinids, const TArray<VSMatrix>& boneData, int boneStartPosition)
 {
+	// The vertex buffer is empty if the geometry could not be read
+	if (BadGeometry)
+		return;
+
 	renderer->SetupFrame(this, 0, 0, NumVertices, boneData, boneStartPosition);
 
 	FGameTexture* lastSkin = nullptr;
@@ -506,24 +535,37 @@ void IQMModel::RenderFrame(FModelRenderer* renderer, FGameTexture* skin, int fra
 	}
 }
 
-void IQMModel::BuildVertexBuffer(FModelRenderer* renderer)
+bool IQMModel::PackGeometry()
 {
-	if (!GetVertexBuffer(renderer->GetType()))
+	if (!LoadGeometry())
 	{
-		LoadGeometry();
+		// Don't stage a half read vertex array, the caller will fall back to the synchronous path.
+		UnloadGeometry();
+		BadGeometry = true;
+		return false;
+	}
+	BadGeometry = false;
 
-		auto vbuf = renderer->CreateVertexBuffer(true, true);
-		SetVertexBuffer(renderer->GetType(), vbuf);
+	mStagedVertices.Swap(Vertices);
+	mStagedIndices.Resize(Triangles.Size() * 3);
+	memcpy(mStagedIndices.Data(), Triangles.Data(), Triangles.Size() * sizeof(unsigned int) * 3);
+	mStaged = true;
 
-		FModelVertex* vertptr = vbuf->LockVertexBuffer(Vertices.Size());
-		memcpy(vertptr, Vertices.Data(), Vertices.Size() * sizeof(FModelVertex));
-		vbuf->UnlockVertexBuffer();
+	UnloadGeometry();
+	return true;
+}
 
-		unsigned int* indxptr = vbuf->LockIndexBuffer(Triangles.Size() * 3);
-		memcpy(indxptr, Triangles.Data(), Triangles.Size() * sizeof(unsigned int) * 3);
-		vbuf->UnlockIndexBuffer();
+void IQMModel::BuildVertexBuffer(FModelRenderer* renderer)
+{
+	if (!GetVertexBuffer(renderer->GetType()))
+	{
+		// If packing fails again an empty buffer is uploaded, so the model is skipped instead of retried every frame
+		if (!HasStagedGeometry() && !PackGeometry())
+		{
+			Printf(PRINT_HIGH, "LoadModel: Unable to read the geometry of '%s'\n", fileSystem.GetFileFullName(mLumpNum));
+		}
 
-		UnloadGeometry();
+		UploadStagedGeometry(renderer, true, true);
 	}
 }
 
@@ -560,106 +602,225 @@ static TRS InterpolateBone(const TRS &from, const TRS &to, float t, float invt)
 	return bone;
 }
 
-const TArray<VSMatrix> IQMModel::CalculateBones(int frame1, int frame2, float inter, int frame1_prev, float inter1_prev, int frame2_prev, float inter2_prev, const TArray<TRS>* animationData, DBoneComponents* boneComponentData, int index)
+//===========================================================================
+//
+// Builds translate * rotate(quaternion) * scale directly instead of
+// going through three separate matrix multiplications
+//
+//===========================================================================
+
+static void ComposeBoneMatrix(const TRS &bone, FLOATTYPE *m)
 {
-	const TArray<TRS>& animationFrames = animationData ? *animationData : TRSData;
-	if (Joints.Size() > 0)
+	const FVector4 &q = bone.rotation;
+	const FLOATTYPE x2 = q.X + q.X, y2 = q.Y + q.Y, z2 = q.Z + q.Z;
+	const FLOATTYPE xx = q.X * x2, yy = q.Y * y2, zz = q.Z * z2;
+	const FLOATTYPE xy = q.X * y2, xz = q.X * z2, yz = q.Y * z2;
+	const FLOATTYPE wx = q.W * x2, wy = q.W * y2, wz = q.W * z2;
+
+	m[0] = (1 - yy - zz) * bone.scaling.X;
+	m[1] = (xy + wz) * bone.scaling.X;
+	m[2] = (xz - wy) * bone.scaling.X;
+	m[3] = 0;
+
+	m[4] = (xy - wz) * bone.scaling.Y;
+	m[5] = (1 - xx - zz) * bone.scaling.Y;
+	m[6] = (yz + wx) * bone.scaling.Y;
+	m[7] = 0;
+
+	m[8] = (xz + wy) * bone.scaling.Z;
+	m[9] = (yz - wx) * bone.scaling.Z;
+	m[10] = (1 - xx - yy) * bone.scaling.Z;
+	m[11] = 0;
+
+	m[12] = bone.translation.X;
+	m[13] = bone.translation.Y;
+	m[14] = bone.translation.Z;
+	m[15] = 1;
+}
+
+//===========================================================================
+//
+// result = a * b, column major like VSMatrix::multMatrix
+// result must not alias a or b
+//
+//===========================================================================
+
+#if !defined(NO_SSE) && !defined(USE_DOUBLE) && (defined(_M_X64) || defined(_M_IX86) || defined(__i386__) || defined(__amd64__))
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <xmmintrin.h>
+
+static void MultBoneMatrix(const FLOATTYPE *a, const FLOATTYPE *b, FLOATTYPE *result)
+{
+	const __m128 a0 = _mm_loadu_ps(a);
+	const __m128 a1 = _mm_loadu_ps(a + 4);
+	const __m128 a2 = _mm_loadu_ps(a + 8);
+	const __m128 a3 = _mm_loadu_ps(a + 12);
+
+	for (int j = 0; j < 4; j++)
 	{
-		int numbones = Joints.SSize();
+		__m128 col = _mm_mul_ps(a0, _mm_set1_ps(b[j * 4 + 0]));
+		col = _mm_add_ps(col, _mm_mul_ps(a1, _mm_set1_ps(b[j * 4 + 1])));
+		col = _mm_add_ps(col, _mm_mul_ps(a2, _mm_set1_ps(b[j * 4 + 2])));
+		col = _mm_add_ps(col, _mm_mul_ps(a3, _mm_set1_ps(b[j * 4 + 3])));
+		_mm_storeu_ps(result + j * 4, col);
+	}
+}
 
-		if (boneComponentData->trscomponents[index].SSize() != numbones)
-			boneComponentData->trscomponents[index].Resize(numbones);
-		if (boneComponentData->trsmatrix[index].SSize() != numbones)
-			boneComponentData->trsmatrix[index].Resize(numbones);
+#else
 
-		frame1 = clamp(frame1, 0, (animationFrames.SSize() - 1) / numbones);
-		frame2 = clamp(frame2, 0, (animationFrames.SSize() - 1) / numbones);
+static void MultBoneMatrix(const FLOATTYPE *a, const FLOATTYPE *b, FLOATTYPE *result)
+{
+	for (int j = 0; j < 4; j++)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			result[j * 4 + i] = a[i] * b[j * 4] + a[4 + i] * b[j * 4 + 1] + a[8 + i] * b[j * 4 + 2] + a[12 + i] * b[j * 4 + 3];
+		}
+	}
+}
 
-		int offset1 = frame1 * numbones;
-		int offset2 = frame2 * numbones;
+#endif
 
-		int offset1_1 = frame1_prev * numbones;
-		int offset2_1 = frame2_prev * numbones;
+//===========================================================================
+//
+// IQMModel::CalculateBones
+//
+// Poses are cached per model so that instances sharing the same frames and
+// interpolation (a crowd of enemies started on the same tic) only evaluate
+// the skeleton once. The per-actor components are still refreshed so the
+// incremental path keeps working once the instances drift apart.
+//
+//===========================================================================
 
-		float invt = 1.0f - inter;
-		float invt1 = 1.0f - inter1_prev;
-		float invt2 = 1.0f - inter2_prev;
+void IQMModel::CalculateBones(int frame1, int frame2, float inter, int frame1_prev, float inter1_prev, int frame2_prev, float inter2_prev, const TArray<TRS>* animationData, DBoneComponents* boneComponentData, int index, TArray<VSMatrix>& bones)
+{
+	const TArray<TRS>& animationFrames = animationData ? *animationData : TRSData;
+	if (Joints.Size() == 0)
+	{
+		bones.Clear();
+		return;
+	}
 
-		float swapYZ[16] = { 0.0f };
-		swapYZ[0 + 0 * 4] = 1.0f;
-		swapYZ[1 + 2 * 4] = 1.0f;
-		swapYZ[2 + 1 * 4] = 1.0f;
-		swapYZ[3 + 3 * 4] = 1.0f;
+	int numbones = Joints.SSize();
+
+	TArray<TRS>& components = boneComponentData->trscomponents[index];
+	TArray<VSMatrix>& matrices = boneComponentData->trsmatrix[index];
+
+	if (components.SSize() != numbones)
+		components.Resize(numbones);
+	if (matrices.SSize() != numbones)
+		matrices.Resize(numbones);
+
+	frame1 = clamp(frame1, 0, (animationFrames.SSize() - 1) / numbones);
+	frame2 = clamp(frame2, 0, (animationFrames.SSize() - 1) / numbones);
 
-		TArray<VSMatrix> bones(numbones, true);
-		TArray<bool> modifiedBone(numbones, true);
-		for (int i = 0; i < numbones; i++)
+	// Check the shared pose cache first
+	PoseCacheCounter++;
+	IQMPoseCacheEntry* oldest = &PoseCache[0];
+	for (int c = 0; c < PoseCacheSize; c++)
+	{
+		IQMPoseCacheEntry& entry = PoseCache[c];
+		if (entry.Matrices.SSize() == numbones && entry.Matches(AnimationGeneration, animationData, frame1, frame2, inter, frame1_prev, inter1_prev, frame2_prev, inter2_prev))
 		{
-			TRS prev;
+			entry.LastUsed = PoseCacheCounter;
+			components = entry.Components;
+			matrices = entry.Matrices;
+			bones = entry.Matrices;
+			return;
+		}
+		if (entry.LastUsed < oldest->LastUsed) oldest = &entry;
+	}
 
-			if(frame1 >= 0 && (frame1_prev >= 0 || inter1_prev < 0))
-			{
-				prev = inter1_prev <= 0 ? animationFrames[offset1 + i] : InterpolateBone(animationFrames[offset1_1 + i], animationFrames[offset1 + i], inter1_prev, invt1);
-			}
+	int offset1 = frame1 * numbones;
+	int offset2 = frame2 * numbones;
 
-			TRS next;
+	int offset1_1 = frame1_prev * numbones;
+	int offset2_1 = frame2_prev * numbones;
 
-			if(frame2 >= 0 && (frame2_prev >= 0 || inter2_prev < 0))
-			{
-				next = inter2_prev <= 0 ? animationFrames[offset2 + i] : InterpolateBone(animationFrames[offset2_1 + i], animationFrames[offset2 + i], inter2_prev, invt2);
-			}
+	float invt = 1.0f - inter;
+	float invt1 = 1.0f - inter1_prev;
+	float invt2 = 1.0f - inter2_prev;
 
-			TRS bone;
+	bones.Resize(numbones);
 
-			if(frame1 >= 0 || inter < 0)
-			{
-				bone = inter < 0 ? animationFrames[offset1 + i] : InterpolateBone(prev, next , inter, invt);
-			}
+	// Bit per joint, parents always come before their children in IQM files
+	TArray<uint8_t> modifiedBone(numbones, true);
+	FLOATTYPE local[16], temp[16];
 
-			if (Joints[i].Parent >= 0 && modifiedBone[Joints[i].Parent])
-			{
-				boneComponentData->trscomponents[index][i] = bone;
-				modifiedBone[i] = true;
-			}
-			else if (boneComponentData->trscomponents[index][i].Equals(bone))
-			{
-				bones[i] = boneComponentData->trsmatrix[index][i];
-				modifiedBone[i] = false;
-				continue;
-			}
-			else
-			{
-				boneComponentData->trscomponents[index][i] = bone;
-				modifiedBone[i] = true;
-			}
+	for (int i = 0; i < numbones; i++)
+	{
+		TRS prev;
 
-			VSMatrix m;
-			m.loadIdentity();
-			m.translate(bone.translation.X, bone.translation.Y, bone.translation.Z);
-			m.multQuaternion(bone.rotation);
-			m.scale(bone.scaling.X, bone.scaling.Y, bone.scaling.Z);
+		if(frame1 >= 0 && (frame1_prev >= 0 || inter1_prev < 0))
+		{
+			prev = inter1_prev <= 0 ? animationFrames[offset1 + i] : InterpolateBone(animationFrames[offset1_1 + i], animationFrames[offset1 + i], inter1_prev, invt1);
+		}
 
-			VSMatrix& result = bones[i];
-			if (Joints[i].Parent >= 0)
-			{
-				result = bones[Joints[i].Parent];
-				result.multMatrix(swapYZ);
-				result.multMatrix(baseframe[Joints[i].Parent]);
-				result.multMatrix(m);
-				result.multMatrix(inversebaseframe[i]);
-			}
-			else
-			{
-				result.loadMatrix(swapYZ);
-				result.multMatrix(m);
-				result.multMatrix(inversebaseframe[i]);
-			}
-			result.multMatrix(swapYZ);
+		TRS next;
+
+		if(frame2 >= 0 && (frame2_prev >= 0 || inter2_prev < 0))
+		{
+			next = inter2_prev <= 0 ? animationFrames[offset2 + i] : InterpolateBone(animationFrames[offset2_1 + i], animationFrames[offset2 + i], inter2_prev, invt2);
+		}
+
+		TRS bone;
+
+		if(frame1 >= 0 || inter < 0)
+		{
+			bone = inter < 0 ? animationFrames[offset1 + i] : InterpolateBone(prev, next , inter, invt);
 		}
 
-		boneComponentData->trsmatrix[index] = bones;
+		int parent = Joints[i].Parent;
 
-		return bones;
+		if (parent >= 0 && modifiedBone[parent])
+		{
+			components[i] = bone;
+			modifiedBone[i] = true;
+		}
+		else if (components[i].Equals(bone))
+		{
+			bones[i] = matrices[i];
+			modifiedBone[i] = false;
+			continue;
+		}
+		else
+		{
+			components[i] = bone;
+			modifiedBone[i] = true;
+		}
+
+		// bones[parent] * swapYZ * baseframe[parent] * m * inversebaseframe[i] * swapYZ
+		ComposeBoneMatrix(bone, local);
+		MultBoneMatrix(bonePreTransform[i].get(), local, temp);
+		if (parent >= 0)
+		{
+			MultBoneMatrix(temp, bonePostTransform[i].get(), local);
+			MultBoneMatrix(bones[parent].get(), local, temp);
+			bones[i].loadMatrix(temp);
+		}
+		else
+		{
+			MultBoneMatrix(temp, bonePostTransform[i].get(), local);
+			bones[i].loadMatrix(local);
+		}
 	}
-	return {};
+
+	matrices = bones;
+
+	// Replace the least recently used pose
+	oldest->AnimationData = animationData;
+	oldest->Generation = AnimationGeneration;
+	oldest->Frame1 = frame1;
+	oldest->Frame2 = frame2;
+	oldest->Inter = inter;
+	oldest->Frame1Prev = frame1_prev;
+	oldest->Inter1Prev = inter1_prev;
+	oldest->Frame2Prev = frame2_prev;
+	oldest->Inter2Prev = inter2_prev;
+	oldest->LastUsed = PoseCacheCounter;
+	oldest->Components = components;
+	oldest->Matrices = bones;
 }
@@ -239,65 +239,78 @@ void FMD3Model::LoadGeometry(FileSys::FileData* lumpData)
 //
 //===========================================================================
 
-void FMD3Model::BuildVertexBuffer(FModelRenderer *renderer)
+bool FMD3Model::PackGeometry()
 {
-	if (!GetVertexBuffer(renderer->GetType()))
-	{
-		// If we already have the data, don't read it again
-		// Data could have been created during background fetch
-		if (Surfaces.size() > 0 && Surfaces[0].Vertices.Size() == 0) {
-			auto lumpdata = fileSystem.ReadFile(mLumpNum);
-			LoadGeometry(&lumpdata);
-		}
+	auto lumpdata = ReadGeometryLump(mLumpNum);
+	LoadGeometry(&lumpdata);
 
-		unsigned int vbufsize = 0;
-		unsigned int ibufsize = 0;
+	unsigned int vbufsize = 0;
+	unsigned int ibufsize = 0;
 
-		for (unsigned i = 0; i < Surfaces.Size(); i++)
-		{
-			MD3Surface * surf = &Surfaces[i];
-			vbufsize += Frames.Size() * surf->numVertices;
-			ibufsize += 3 * surf->numTriangles;
-		}
+	for (unsigned i = 0; i < Surfaces.Size(); i++)
+	{
+		MD3Surface * surf = &Surfaces[i];
+		vbufsize += Frames.Size() * surf->numVertices;
+		ibufsize += 3 * surf->numTriangles;
+	}
 
-		auto vbuf = renderer->CreateVertexBuffer(true, Frames.Size() == 1);
-		SetVertexBuffer(renderer->GetType(), vbuf);
+	mStagedVertices.Resize(vbufsize);
+	mStagedIndices.Resize(ibufsize);
 
-		FModelVertex *vertptr = vbuf->LockVertexBuffer(vbufsize);
-		unsigned int *indxptr = vbuf->LockIndexBuffer(ibufsize);
+	FModelVertex *vertptr = mStagedVertices.Data();
+	unsigned int *indxptr = mStagedIndices.Data();
 
-		assert(vertptr != nullptr && indxptr != nullptr);
+	unsigned int vindex = 0, iindex = 0;
 
-		unsigned int vindex = 0, iindex = 0;
+	for (unsigned i = 0; i < Surfaces.Size(); i++)
+	{
+		MD3Surface * surf = &Surfaces[i];
 
-		for (unsigned i = 0; i < Surfaces.Size(); i++)
+		surf->vindex = vindex;
+		surf->iindex = iindex;
+		for (unsigned j = 0; j < Frames.Size() * surf->numVertices; j++)
 		{
-			MD3Surface * surf = &Surfaces[i];
+			MD3Vertex* vert = &surf->Vertices[j];
 
-			surf->vindex = vindex;
-			surf->iindex = iindex;
-			for (unsigned j = 0; j < Frames.Size() * surf->numVertices; j++)
-			{
-				MD3Vertex* vert = &surf->Vertices[j];
+			FModelVertex *bvert = &vertptr[vindex++];
 
-				FModelVertex *bvert = &vertptr[vindex++];
-
-				int tc = j % surf->numVertices;
-				bvert->Set(vert->x, vert->z, vert->y, surf->Texcoords[tc].s, surf->Texcoords[tc].t);
-				bvert->SetNormal(vert->nx, vert->nz, vert->ny);
-			}
+			int tc = j % surf->numVertices;
+			bvert->Set(vert->x, vert->z, vert->y, surf->Texcoords[tc].s, surf->Texcoords[tc].t);
+			bvert->SetNormal(vert->nx, vert->nz, vert->ny);
+		}
 
-			for (unsigned k = 0; k < surf->numTriangles; k++)
+		for (unsigned k = 0; k < surf->numTriangles; k++)
+		{
+			for (int l = 0; l < 3; l++)
 			{
-				for (int l = 0; l < 3; l++)
-				{
-					indxptr[iindex++] = surf->Tris[k].VertIndex[l];
-				}
+				indxptr[iindex++] = surf->Tris[k].VertIndex[l];
 			}
-			surf->UnloadGeometry();
 		}
-		vbuf->UnlockVertexBuffer();
-		vbuf->UnlockIndexBuffer();
+		surf->UnloadGeometry();
+	}
+
+	mStaged = true;
+	return true;
+}
+
+//===========================================================================
+//
+//
+//
+//===========================================================================
+
+void FMD3Model::BuildVertexBuffer(FModelRenderer *renderer)
+{
+	if (!GetVertexBuffer(renderer->GetType()))
+	{
+		// If we already have the data, don't pack it again
+		// Data could have been created during background fetch
+		if (!HasStagedGeometry())
+		{
+			PackGeometry();
+		}
+
+		UploadStagedGeometry(renderer, true, Frames.Size() == 1);
 	}
 }
 
@@ -37,6 +37,7 @@
  */
 bool FOBJModel::Load(const char* fn, int lumpnum, const char* buffer, int length)
 {
+	mLumpNum = lumpnum;
 	auto objName = fileSystem.GetFileFullPath(lumpnum);
 	FString objBuf(buffer, length);
 
@@ -353,17 +354,15 @@ int FOBJModel::ResolveIndex(int origIndex, FaceElement el)
 }
 
 /**
- * Construct the vertex buffer for this model
+ * Triangulate the surfaces and pack the vertex data for this model
  *
- * @param renderer A pointer to the model renderer. Used to allocate the vertex buffer.
+ * Safe to call from the model loader thread, the surfaces are only read by the
+ * main thread after the model has been marked as ready.
+ *
+ * @return Whether or not the geometry was packed
  */
-void FOBJModel::BuildVertexBuffer(FModelRenderer *renderer)
+bool FOBJModel::PackGeometry()
 {
-	if (GetVertexBuffer(renderer->GetType()))
-	{
-		return;
-	}
-
 	unsigned int vbufsize = 0;
 
 	for (size_t i = 0; i < surfaces.Size(); i++)
@@ -378,10 +377,8 @@ void FOBJModel::BuildVertexBuffer(FModelRenderer *renderer)
 		AddVertFaces();
 	}
 
-	auto vbuf = renderer->CreateVertexBuffer(false,true);
-	SetVertexBuffer(renderer->GetType(), vbuf);
-
-	FModelVertex *vertptr = vbuf->LockVertexBuffer(vbufsize);
+	mStagedVertices.Resize(vbufsize);
+	FModelVertex *vertptr = mStagedVertices.Data();
 
 	for (unsigned int i = 0; i < surfaces.Size(); i++)
 	{
@@ -434,8 +431,30 @@ void FOBJModel::BuildVertexBuffer(FModelRenderer *renderer)
 			vertFaces[i].Clear();
 		}
 		delete[] vertFaces;
+		vertFaces = nullptr;
+	}
+	mStaged = true;
+	return true;
+}
+
+/**
+ * Construct the vertex buffer for this model
+ *
+ * @param renderer A pointer to the model renderer. Used to allocate the vertex buffer.
+ */
+void FOBJModel::BuildVertexBuffer(FModelRenderer *renderer)
+{
+	if (GetVertexBuffer(renderer->GetType()))
+	{
+		return;
 	}
-	vbuf->UnlockVertexBuffer();
+
+	if (!HasStagedGeometry())
+	{
+		PackGeometry();
+	}
+
+	UploadStagedGeometry(renderer, false, true);
 }
 
 /**
@@ -64,15 +64,16 @@ bool FUE1Model::Load( const char *filename, int lumpnum, const char *buffer, int
 		mAnivLump = lumpnum;
 		mDataLump = lumpnum2;
 	}
+	mLumpNum = lumpnum;
 	return true;
 }
 
 void FUE1Model::LoadGeometry()
 {
 	const char *buffer, *buffer2;
-	auto lump =  fileSystem.ReadFile(mDataLump);
+	auto lump = ReadGeometryLump(mDataLump);
 	buffer = lump.string();
-	auto lump2 =  fileSystem.ReadFile(mAnivLump);
+	auto lump2 = ReadGeometryLump(mAnivLump);
 	buffer2 = lump2.string();
 	// map structures
 	dhead = (const d3dhead*)(buffer);
@@ -270,18 +271,15 @@ void FUE1Model::RenderFrame( FModelRenderer *renderer, FGameTexture *skin, int f
 	renderer->SetInterpolation(0.f);
 }
 
-void FUE1Model::BuildVertexBuffer( FModelRenderer *renderer )
+bool FUE1Model::PackGeometry()
 {
-	if (GetVertexBuffer(renderer->GetType()))
-		return;
 	LoadGeometry();
 	int vsize = 0;
 	for ( int i=0; i<numGroups; i++ )
 		vsize += groups[i].numPolys*3;
 	vsize *= numFrames;
-	auto vbuf = renderer->CreateVertexBuffer(false,numFrames==1);
-	SetVertexBuffer(renderer->GetType(), vbuf);
-	FModelVertex *vptr = vbuf->LockVertexBuffer(vsize);
+	mStagedVertices.Resize(vsize);
+	FModelVertex *vptr = mStagedVertices.Data();
 	int vidx = 0;
 	for ( int i=0; i<numFrames; i++ )
 	{
@@ -306,8 +304,18 @@ void FUE1Model::BuildVertexBuffer( FModelRenderer *renderer )
 			}
 		}
 	}
-	vbuf->UnlockVertexBuffer();
+	mStaged = true;
 	UnloadGeometry(); // don't forget this, save precious RAM
+	return true;
+}
+
+void FUE1Model::BuildVertexBuffer( FModelRenderer *renderer )
+{
+	if (GetVertexBuffer(renderer->GetType()))
+		return;
+	if (!HasStagedGeometry())
+		PackGeometry();
+	UploadStagedGeometry(renderer,false,numFrames==1);
 }
 
 void FUE1Model::AddSkins( uint8_t *hitlist, const FTextureID* surfaceskinids)
@@ -322,30 +322,39 @@ void FVoxelModel::Initialize()
 //
 //===========================================================================
 
+bool FVoxelModel::PackGeometry()
+{
+	mVertices.Clear();
+	mIndices.Clear();
+	Initialize();
+
+	mNumIndices = mIndices.Size();
+	mStagedVertices.Swap(mVertices);
+	mStagedIndices.Swap(mIndices);
+	mStaged = true;
+
+	// delete our temporary buffers
+	mVertices.Reset();
+	mIndices.Reset();
+	return true;
+}
+
+//===========================================================================
+//
+// 
+//
+//===========================================================================
+
 void FVoxelModel::BuildVertexBuffer(FModelRenderer *renderer)
 {
 	if (!GetVertexBuffer(renderer->GetType()))
 	{
-		Initialize();
-
-		auto vbuf = renderer->CreateVertexBuffer(true, true);
-		SetVertexBuffer(renderer->GetType(), vbuf);
-
-		FModelVertex *vertptr = vbuf->LockVertexBuffer(mVertices.Size());
-		unsigned int *indxptr = vbuf->LockIndexBuffer(mIndices.Size());
-
-		memcpy(vertptr, &mVertices[0], sizeof(FModelVertex)* mVertices.Size());
-		memcpy(indxptr, &mIndices[0], sizeof(unsigned int)* mIndices.Size());
-
-		vbuf->UnlockVertexBuffer();
-		vbuf->UnlockIndexBuffer();
-		mNumIndices = mIndices.Size();
+		if (!HasStagedGeometry())
+		{
+			PackGeometry();
+		}
 
-		// delete our temporary buffers
-		mVertices.Clear();
-		mIndices.Clear();
-		mVertices.ShrinkToFit();
-		mIndices.ShrinkToFit();
+		UploadStagedGeometry(renderer, true, true);
 	}
 }
 
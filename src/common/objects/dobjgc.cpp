@@ -56,6 +56,11 @@
 
 // HEADER FILES ------------------------------------------------------------
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <vector>
 #include "dobject.h"
 
 #include "c_dispatch.h"
@@ -63,6 +68,8 @@
 #include "stats.h"
 #include "printf.h"
 #include "cmdlib.h"
+#include "c_cvars.h"
+#include "workerpool.h"
 
 // MACROS ------------------------------------------------------------------
 
@@ -107,6 +114,26 @@
 // Cost of destroying an object
 #define GCDESTROYCOST		15
 
+// Objects are pooled in size classes of this granularity, which also
+// keeps them aligned to cache lines inside their slabs.
+#define POOLGRANULARITY		64
+
+// Bigger objects are allocated with M_Malloc
+#define POOLMAXSIZE			8192
+
+// Every object allocation starts with a header pointing to its slab,
+// or null if it didn't come from a pool.
+#define POOLHEADER			16
+
+// Minimum size of a slab
+#define POOLSLABSIZE		(64 * 1024)
+
+// Propagation steps smaller than this are not worth waking the mark threads for
+#define PARALLELMARKMIN		(256 * 1024)
+
+// Number of gray objects a mark thread keeps to itself before sharing
+#define PARALLELMARKBATCH	64
+
 // TYPES -------------------------------------------------------------------
 
 class FAveragizer
@@ -130,6 +157,9 @@ struct FStepStats
 	cycle_t Clock[GC::GCS_COUNT];
 	size_t BytesCovered[GC::GCS_COUNT];
 	int Count[GC::GCS_COUNT];
+	int PoolAllocs, PoolFrees;		// objects taken from and returned to the object pools
+	size_t StepLimit;				// sum of the byte limits of all steps
+	int ParallelMarks;				// propagation steps that used the mark threads
 
 	void Format(FString &out);
 	void Reset();
@@ -172,6 +202,34 @@ bool HadToDestroy;
 
 static FAveragizer AllocHistory;// Tracks allocation rate over time
 static cycle_t GCTime;			// Track time spent in GC
+static size_t StepBudget;		// Bytes the current step may still cover
+
+// Gray objects of the mark thread this is running on, or null if marking normally.
+static thread_local std::vector<DObject *> *LocalGray;
+
+struct FObjectPool;
+
+struct FObjectSlab
+{
+	FObjectPool *Pool;
+	uint8_t *Memory;
+	void *FreeList;
+	unsigned Live;
+	unsigned Index;				// in Pool->Slabs
+};
+
+struct FObjectPool
+{
+	size_t SlotSize;
+	unsigned SlotsPerSlab;
+	unsigned FirstFree;			// no slab before this one has any room left
+	TArray<FObjectSlab *> Slabs;
+};
+
+// Never freed, objects may still get deleted while static data is being destroyed.
+static FObjectPool *Pools = new FObjectPool[POOLMAXSIZE / POOLGRANULARITY]();
+static size_t PoolSlabBytes;
+static int PoolLiveObjects;
 
 // CODE --------------------------------------------------------------------
 
@@ -207,6 +265,18 @@ void SetThreshold()
 	Threshold = (std::min(Estimate, AllocBytes) / 100) * Pause;
 }
 
+//==========================================================================
+//
+// Mark threads only ever change the mark bits, and do so atomically.
+//
+//==========================================================================
+
+static inline std::atomic<uint32_t> &FlagsOf(DObject *obj)
+{
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(obj->ObjectFlags), "ObjectFlags can't be updated atomically");
+	return *reinterpret_cast<std::atomic<uint32_t> *>(&obj->ObjectFlags);
+}
+
 //==========================================================================
 //
 // PropagateMark
@@ -226,6 +296,152 @@ size_t PropagateMark()
 		obj->GetClass()->Size;
 }
 
+//==========================================================================
+//
+// ParallelPropagateMark
+//
+// Drains the gray list with several threads until it is empty or the
+// budget is used up. This only ever runs inside a collection step, i.e.
+// while nothing else touches the objects, so the write barrier never sees
+// it. Marking is the only thing done concurrently: a white object is
+// claimed with an atomic update of its flags, so only one thread ever
+// propagates it. Objects whose class hasn't built its pointer tables yet
+// are left to the game thread, since building them isn't thread safe.
+//
+//==========================================================================
+
+CVAR(Bool, gc_parallelmark, true, 0)
+
+struct FParallelMark
+{
+	std::mutex Lock;
+	std::vector<DObject *> Shared;		// up for grabs by any thread
+	std::vector<DObject *> Leftover;	// still gray when the budget ran out
+	std::vector<DObject *> Deferred;	// for the game thread
+	std::atomic<size_t> Done{ 0 };
+	size_t Budget;
+	int Busy;
+
+	bool CanPropagate(DObject *obj)
+	{
+		auto info = obj->GetClass();
+		return (obj->ObjectFlags & OF_EuthanizeMe) || PClass::bShutdown ||
+			(info->FlatPointers != nullptr && info->ArrayPointers != nullptr && info->MapPointers != nullptr);
+	}
+
+	// Returns false once there is nothing left to do.
+	bool Refill(std::vector<DObject *> &local, bool &busy)
+	{
+		for (;;)
+		{
+			{
+				std::lock_guard<std::mutex> lock(Lock);
+				if (Done >= Budget)
+				{
+					if (busy) Busy--;
+					busy = false;
+					return false;
+				}
+				if (!Shared.empty())
+				{
+					size_t take = std::min<size_t>(Shared.size(), PARALLELMARKBATCH);
+					local.insert(local.end(), Shared.end() - take, Shared.end());
+					Shared.resize(Shared.size() - take);
+					if (!busy) Busy++;
+					busy = true;
+					return true;
+				}
+				if (busy) Busy--;
+				busy = false;
+				if (Busy == 0) return false;
+			}
+			std::this_thread::yield();
+		}
+	}
+
+	void Run()
+	{
+		std::vector<DObject *> local;
+		bool busy = false;
+		LocalGray = &local;
+
+		while (local.size() > 0 || Refill(local, busy))
+		{
+			if (Done >= Budget) break;
+
+			DObject *obj = local.back();
+			local.pop_back();
+			if (!CanPropagate(obj))
+			{
+				std::lock_guard<std::mutex> lock(Lock);
+				Deferred.push_back(obj);
+				continue;
+			}
+			FlagsOf(obj).fetch_or((uint32_t)OF_Black);
+			Done += !(obj->ObjectFlags & OF_EuthanizeMe) ? obj->PropagateMark() : obj->GetClass()->Size;
+
+			// Hand some work to the idle threads.
+			if (local.size() > 2 * PARALLELMARKBATCH)
+			{
+				std::lock_guard<std::mutex> lock(Lock);
+				if (Shared.empty())
+				{
+					Shared.insert(Shared.end(), local.begin(), local.begin() + PARALLELMARKBATCH);
+					local.erase(local.begin(), local.begin() + PARALLELMARKBATCH);
+				}
+			}
+		}
+
+		LocalGray = nullptr;
+		std::lock_guard<std::mutex> lock(Lock);
+		if (busy) Busy--;
+		Leftover.insert(Leftover.end(), local.begin(), local.end());
+	}
+};
+
+static size_t ParallelPropagateMark(size_t budget)
+{
+	FParallelMark work;
+	work.Budget = budget;
+	work.Busy = 0;
+	for (DObject *obj = Gray; obj != nullptr; obj = obj->GCNext)
+	{
+		work.Shared.push_back(obj);
+	}
+	Gray = nullptr;
+
+	auto &pool = WorkerPool();
+	std::vector<std::future<void>> jobs;
+	for (int i = 0; i < std::min(pool.size(), 7); i++)
+	{
+		jobs.push_back(pool.push([&work](int) { work.Run(); }));
+	}
+	work.Run();
+	for (auto &job : jobs)
+	{
+		job.wait();
+	}
+	StepStats.ParallelMarks++;
+
+	// Everything that didn't get done goes back on the gray list.
+	for (auto list : { &work.Shared, &work.Leftover, &work.Deferred })
+	{
+		for (auto obj : *list)
+		{
+			obj->GCNext = Gray;
+			Gray = obj;
+		}
+	}
+
+	// Take care of the objects the mark threads couldn't do right away, so they don't stall the next step.
+	size_t done = work.Done;
+	for (size_t i = 0; i < work.Deferred.size() && Gray != nullptr && done < budget; i++)
+	{
+		done += PropagateMark();
+	}
+	return done;
+}
+
 //==========================================================================
 //
 // SweepObjects
@@ -328,13 +544,42 @@ void Mark(DObject **obj)
 		}
 		else if (lobj->IsWhite())
 		{
-			lobj->White2Gray();
-			lobj->GCNext = Gray;
-			Gray = lobj;
+			if (LocalGray == nullptr)
+			{
+				lobj->White2Gray();
+				lobj->GCNext = Gray;
+				Gray = lobj;
+			}
+			else if (FlagsOf(lobj).fetch_and(~(uint32_t)OF_WhiteBits) & OF_WhiteBits)
+			{ // Only the thread that actually turned it gray gets to propagate it.
+				LocalGray->push_back(lobj);
+			}
 		}
 	}
 }
 
+//==========================================================================
+//
+// PushGray
+//
+// Puts an object that has already been turned gray back on the gray list,
+// for objects that do their propagation in several parts.
+//
+//==========================================================================
+
+void PushGray(DObject *obj)
+{
+	if (LocalGray != nullptr)
+	{
+		LocalGray->push_back(obj);
+	}
+	else
+	{
+		obj->GCNext = Gray;
+		Gray = obj;
+	}
+}
+
 //==========================================================================
 //
 // MarkArray
@@ -459,6 +704,10 @@ static size_t SingleStep()
 	case GCS_Propagate:
 		if (Gray != nullptr)
 		{
+			if (gc_parallelmark && StepBudget >= PARALLELMARKMIN && Gray->GCNext != nullptr)
+			{
+				return ParallelPropagateMark(StepBudget);
+			}
 			return PropagateMark();
 		}
 		else
@@ -520,9 +769,11 @@ void Step()
 
 	size_t did = 0;
 	size_t lim = CalcStepSize();
+	StepStats.StepLimit += lim;
 
 	do
 	{
+		StepBudget = lim;
 		size_t done = SingleStep();
 		did += done;
 		if (done < lim)
@@ -546,6 +797,7 @@ void Step()
 			StepStats.Count[enter_state]++;
 		}
 	} while (lim && State != GCS_Pause);
+	StepBudget = 0;
 
 	StepStats.Clock[enter_state].Unclock();
 	StepStats.BytesCovered[enter_state] += did;
@@ -562,6 +814,7 @@ void Step()
 
 void FullGC()
 {
+	StepBudget = ~(size_t)0;
 	bool ContinueCheck = true;
 	while (ContinueCheck)
 	{
@@ -590,6 +843,7 @@ void FullGC()
 			ContinueCheck |= HadToDestroy;
 		} while (HadToDestroy);
 	}
+	StepBudget = 0;
 }
 
 //==========================================================================
@@ -708,6 +962,121 @@ void DelSoftRoot(DObject *obj)
 	}
 }
 
+//==========================================================================
+//
+// Object pools
+//
+// All DObjects are allocated here. Objects up to POOLMAXSIZE come from
+// slabs of equally sized slots, one set of slabs per size class. New
+// objects always go to the first slab with room, so live objects stay
+// packed in as few slabs as possible instead of being spread all over the
+// heap by the spawn and destroy churn of the playsim.
+//
+//==========================================================================
+
+CVAR(Bool, gc_objectpools, true, 0)
+
+static FObjectSlab *NewSlab(FObjectPool &pool)
+{
+	auto slab = new FObjectSlab;
+	size_t bytes = pool.SlotSize * pool.SlotsPerSlab;
+	slab->Pool = &pool;
+	slab->Memory = (uint8_t *)malloc(bytes + POOLGRANULARITY);
+	if (slab->Memory == nullptr)
+	{
+		I_FatalError("Could not allocate %zu bytes for object pool", bytes);
+	}
+	slab->Live = 0;
+	slab->Index = pool.Slabs.Push(slab);
+	PoolSlabBytes += bytes;
+
+	// Chain the slots up in address order, so they get used front to back.
+	uint8_t *base = (uint8_t *)(((uintptr_t)slab->Memory + POOLGRANULARITY - 1) & ~(uintptr_t)(POOLGRANULARITY - 1));
+	slab->FreeList = nullptr;
+	for (unsigned i = pool.SlotsPerSlab; i-- > 0; )
+	{
+		uint8_t *slot = base + i * pool.SlotSize;
+		*(void **)slot = slab->FreeList;
+		slab->FreeList = slot;
+	}
+	return slab;
+}
+
+static void FreeSlab(FObjectPool &pool)
+{
+	FObjectSlab *slab;
+	pool.Slabs.Pop(slab);
+	PoolSlabBytes -= pool.SlotSize * pool.SlotsPerSlab;
+	free(slab->Memory);
+	delete slab;
+}
+
+void *AllocObject(size_t size)
+{
+	size_t slotsize = (size + POOLHEADER + POOLGRANULARITY - 1) & ~(size_t)(POOLGRANULARITY - 1);
+	FObjectSlab *slab = nullptr;
+	uint8_t *slot;
+
+	if (slotsize > POOLMAXSIZE || !gc_objectpools)
+	{
+		slot = (uint8_t *)M_Malloc(size + POOLHEADER);
+	}
+	else
+	{
+		auto &pool = Pools[slotsize / POOLGRANULARITY - 1];
+		if (pool.SlotSize == 0)
+		{
+			pool.SlotSize = slotsize;
+			pool.SlotsPerSlab = max<unsigned>(16, unsigned(POOLSLABSIZE / slotsize));
+		}
+		while (pool.FirstFree < pool.Slabs.Size() && pool.Slabs[pool.FirstFree]->FreeList == nullptr)
+		{
+			pool.FirstFree++;
+		}
+		slab = pool.FirstFree < pool.Slabs.Size() ? pool.Slabs[pool.FirstFree] : NewSlab(pool);
+
+		slot = (uint8_t *)slab->FreeList;
+		slab->FreeList = *(void **)slot;
+		slab->Live++;
+		PoolLiveObjects++;
+		StepStats.PoolAllocs++;
+		ReportAlloc(slotsize);
+	}
+	*(FObjectSlab **)slot = slab;
+	return slot + POOLHEADER;
+}
+
+void FreeObject(void *mem)
+{
+	if (mem == nullptr) return;
+
+	uint8_t *slot = (uint8_t *)mem - POOLHEADER;
+	FObjectSlab *slab = *(FObjectSlab **)slot;
+	if (slab == nullptr)
+	{
+		M_Free(slot);
+		return;
+	}
+
+	auto &pool = *slab->Pool;
+	*(void **)slot = slab->FreeList;
+	slab->FreeList = slot;
+	slab->Live--;
+	PoolLiveObjects--;
+	StepStats.PoolFrees++;
+	ReportDealloc(pool.SlotSize);
+
+	if (slab->Index < pool.FirstFree)
+	{
+		pool.FirstFree = slab->Index;
+	}
+	// Give back empty slabs at the end, but keep one around for the next spawns.
+	while (pool.Slabs.Size() > 1 && pool.Slabs.Last()->Live == 0 && pool.Slabs[pool.Slabs.Size() - 2]->Live == 0)
+	{
+		FreeSlab(pool);
+	}
+}
+
 }
 
 //==========================================================================
@@ -787,6 +1156,7 @@ ADD_STAT(gc)
 		(GC::AllocBytes + 1023) >> 10,
 		(GC::Estimate + 1023) >> 10,
 		(GC::Threshold + 1023) >> 10);
+	out.AppendFormat("\nPools: %d objects in %zuK of slabs", GC::PoolLiveObjects, (GC::PoolSlabBytes + 1023) >> 10);
 	return out;
 }
 
@@ -804,6 +1174,9 @@ void FStepStats::Reset()
 		BytesCovered[i] = 0;
 		Clock[i].Reset();
 	}
+	PoolAllocs = PoolFrees = 0;
+	StepLimit = 0;
+	ParallelMarks = 0;
 }
 
 //==========================================================================
@@ -827,7 +1200,7 @@ void FStepStats::Format(FString &out)
 			"-PSD"[i],	/* Stage prefixes: (P)ropagate, (S)weep, (D)estroy */
 			(BytesCovered[i] + 1023) >> 10, count, count != 0 ? time / count : time);
 	}
-	out << TEXTCOLOR_GREEN;
+	out.AppendFormat(TEXTCOLOR_GREEN "[+%d -%d] [Lim%6zuK %d*MT]", PoolAllocs, PoolFrees, (StepLimit + 1023) >> 10, ParallelMarks);
 }
 
 //==========================================================================
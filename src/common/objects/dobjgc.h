@@ -92,6 +92,10 @@ namespace GC
 	// Does a complete collection.
 	void FullGC();
 
+	// Memory for DObjects. Small objects come from per size class pools.
+	void *AllocObject(size_t size);
+	void FreeObject(void *mem);
+
 	// Handles the grunt work for a write barrier.
 	void Barrier(DObject *pointing, DObject *pointed);
 
@@ -137,6 +141,10 @@ namespace GC
 	// Marks an array of objects.
 	void MarkArray(DObject **objs, size_t count);
 
+	// Puts an object that is still gray back on the gray list, for objects
+	// that only propagate part of their pointers at a time.
+	void PushGray(DObject *obj);
+
 	// For cleanup
 	void DelSoftRootHead();
 
@@ -314,9 +314,8 @@ bool GlTexLoadThread::loadResource(GlTexLoadIn & input, GlTexLoadOut & output) {
 
 
 bool GLModelLoadThread::loadResource(GLModelLoadIn& input, GLModelLoadOut& output) {
-	FileReader reader = fileSystem.OpenFileReader(input.lump, FileSys::EReaderType::READER_NEW, 0);
-	output.data = reader.Read();
-	reader.Close();
+	// Parse and pack the geometry here, the main thread only has to copy it into the vertex buffer
+	output.packed = input.model->PackGeometry();
 
 	output.lump = input.lump;
 	output.model = input.model;
@@ -382,7 +381,7 @@ void OpenGLFrameBuffer::PrequeueMaterial(FMaterial * mat, int translation)
 
 
 bool OpenGLFrameBuffer::BackgroundLoadModel(FModel* model) {
-	if (!model || model->GetLoadState() == FModel::READY || model->GetLumpNum() <= 0)
+	if (!model || model->GetLoadState() == FModel::READY || !model->SupportsBackgroundLoad())
 		return false;
 	if (model->GetLoadState() == FModel::LOADING)
 		return true;
@@ -762,14 +761,12 @@ void OpenGLFrameBuffer::UpdateBackgroundCache(bool flush) {
 
 		if (modelOut.model->GetLoadState() != FModel::LOADING) {
 			statCollisions++;
-			modelOut.data.clear();
 			continue;
 		}
 
-		modelOut.model->LoadGeometry(&modelOut.data);
+		// If packing failed BuildVertexBuffer() will try again on the main thread
 		modelOut.model->SetLoadState(FModel::READY);
-		modelOut.data.clear();
-		statModelsLoaded++;
+		if (modelOut.packed) statModelsLoaded++;
 	}
 
 	// Move recycled objects back to the top of the queue
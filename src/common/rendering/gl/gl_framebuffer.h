@@ -92,7 +92,7 @@ struct GLModelLoadIn {
 
 struct GLModelLoadOut {
 	int lump = -1;
-	FileSys::FileData data;
+	bool packed = false;		// Geometry is staged and only needs to be uploaded
 	FModel* model = nullptr;
 };
 
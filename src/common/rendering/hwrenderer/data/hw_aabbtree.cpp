@@ -23,6 +23,14 @@
 #include <algorithm>
 #include "hw_aabbtree.h"
 
+#if !defined(NO_SSE) && (defined(_M_X64) || defined(_M_IX86) || defined(__i386__) || defined(__amd64__))
+#define AABBTREE_SSE
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <xmmintrin.h>
+#endif
+
 namespace hwrenderer
 {
 
@@ -163,4 +171,132 @@ double LevelAABBTree::IntersectRayLine(const DVector2 &ray_start, const DVector2
 }
 
 
+//==========================================================================
+//
+// Segment batches are walked as packets of 4 through the tree. Each node's
+// box is tested against all active segments at once and only subtrees that
+// still overlap one of them are visited. Segments drop out of the packet as
+// soon as they hit a line.
+//
+// Only the static part of the tree is used. The dynamic polyobject lines
+// are only refreshed by the renderer and may be out of date for gameplay.
+//
+//==========================================================================
+
+void LevelAABBTree::SegmentsBlocked(const DVector2 *starts, const DVector2 *ends, unsigned int count, bool *blocked)
+{
+	for (unsigned int i = 0; i < count; i += 4)
+	{
+		SegmentPacketBlocked(starts + i, ends + i, std::min(count - i, 4u), blocked + i);
+	}
+}
+
+void LevelAABBTree::SegmentPacketBlocked(const DVector2 *starts, const DVector2 *ends, unsigned int count, bool *blocked)
+{
+	for (unsigned int i = 0; i < count; i++) blocked[i] = false;
+	if (dynamicStartNode == 0)
+		return;	// no static lines
+
+	// Lane data for the box tests. Unused lanes get a degenerate segment that is never active.
+	alignas(16) float minx[4], miny[4], maxx[4], maxy[4], nx[4], ny[4], nd[4], absnx[4], absny[4];
+	int active = 0;
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		const DVector2 &s = starts[i < count ? i : 0];
+		const DVector2 &e = ends[i < count ? i : 0];
+		minx[i] = (float)std::min(s.X, e.X);
+		miny[i] = (float)std::min(s.Y, e.Y);
+		maxx[i] = (float)std::max(s.X, e.X);
+		maxy[i] = (float)std::max(s.Y, e.Y);
+		nx[i] = (float)(s.Y - e.Y);
+		ny[i] = (float)(e.X - s.X);
+		nd[i] = nx[i] * (float)s.X + ny[i] * (float)s.Y;
+		absnx[i] = fabsf(nx[i]);
+		absny[i] = fabsf(ny[i]);
+		if (i < count && (nx[i] != 0 || ny[i] != 0)) active |= 1 << i;
+	}
+
+	const float pad = 1.0f;	// keep float rounding from culling a box that just touches a segment
+
+	struct StackEntry { int node, mask; };
+	StackEntry stack[64];
+	int stack_pos = 0;
+	stack[stack_pos++] = { dynamicStartNode - 1, active };	// root of the static subtree
+
+	while (stack_pos > 0 && active != 0)
+	{
+		auto entry = stack[--stack_pos];
+		const AABBTreeNode &node = nodes[entry.node];
+		int mask = entry.mask & active;
+		if (mask == 0) continue;
+
+		float cx = (node.aabb_left + node.aabb_right) * 0.5f, cy = (node.aabb_top + node.aabb_bottom) * 0.5f;
+		float hx = (node.aabb_right - node.aabb_left) * 0.5f + pad, hy = (node.aabb_bottom - node.aabb_top) * 0.5f + pad;
+
+		// The box must overlap the segment's bounds and straddle its line.
+#ifdef AABBTREE_SSE
+		__m128 overlap = _mm_and_ps(
+			_mm_and_ps(_mm_cmple_ps(_mm_load_ps(minx), _mm_set1_ps(node.aabb_right + pad)), _mm_cmpge_ps(_mm_load_ps(maxx), _mm_set1_ps(node.aabb_left - pad))),
+			_mm_and_ps(_mm_cmple_ps(_mm_load_ps(miny), _mm_set1_ps(node.aabb_bottom + pad)), _mm_cmpge_ps(_mm_load_ps(maxy), _mm_set1_ps(node.aabb_top - pad))));
+		__m128 dist = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(nx), _mm_set1_ps(cx)), _mm_mul_ps(_mm_load_ps(ny), _mm_set1_ps(cy))), _mm_load_ps(nd));
+		__m128 absdist = _mm_andnot_ps(_mm_set1_ps(-0.0f), dist);
+		__m128 extent = _mm_add_ps(_mm_mul_ps(_mm_load_ps(absnx), _mm_set1_ps(hx)), _mm_mul_ps(_mm_load_ps(absny), _mm_set1_ps(hy)));
+		mask &= _mm_movemask_ps(_mm_and_ps(overlap, _mm_cmple_ps(absdist, extent)));
+#else
+		int hitmask = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			bool overlap = minx[i] <= node.aabb_right + pad && maxx[i] >= node.aabb_left - pad && miny[i] <= node.aabb_bottom + pad && maxy[i] >= node.aabb_top - pad;
+			float dist = nx[i] * cx + ny[i] * cy - nd[i];
+			if (overlap && fabsf(dist) <= absnx[i] * hx + absny[i] * hy) hitmask |= 1 << i;
+		}
+		mask &= hitmask;
+#endif
+		if (mask == 0) continue;
+
+		if (node.line_index != -1)
+		{
+			for (unsigned int i = 0; i < count; i++)
+			{
+				if ((mask & (1 << i)) && SegmentCrossesLine(starts[i], ends[i], node.line_index))
+				{
+					blocked[i] = true;
+					active &= ~(1 << i);
+				}
+			}
+		}
+		else if (stack_pos + 2 <= 64)
+		{
+			stack[stack_pos++] = { node.right_node, mask };
+			stack[stack_pos++] = { node.left_node, mask };
+		}
+		// else: tree is too deep, skipping the subtree only loses an early out
+	}
+}
+
+bool LevelAABBTree::SegmentCrossesLine(const DVector2 &start, const DVector2 &end, int line_index)
+{
+	// Margin in map units. The tree stores lines as floats so anything closer than this is left undecided.
+	const double margin = 1 / 16.;
+	const AABBTreeLine &line = treelines[line_index];
+
+	DVector2 segdelta = end - start;
+	DVector2 line_pos(line.x, line.y);
+	DVector2 line_delta(line.dx, line.dy);
+
+	double den = segdelta.X * line_delta.Y - segdelta.Y * line_delta.X;
+	if (den == 0) return false;
+
+	DVector2 diff = line_pos - start;
+	double t = (diff.X * line_delta.Y - diff.Y * line_delta.X) / den;	// along the segment
+	double u = (diff.X * segdelta.Y - diff.Y * segdelta.X) / den;		// along the line
+
+	double seglen = segdelta.Length(), linelen = line_delta.Length();
+	if (t * seglen < margin || (1 - t) * seglen < margin) return false;
+	if (u * linelen < margin || (1 - u) * linelen < margin) return false;
+
+	// The crossing must not be nearly parallel either, or the margin above means nothing.
+	return fabs(den) / (seglen * linelen) > 1 / 1024.;
+}
+
 }
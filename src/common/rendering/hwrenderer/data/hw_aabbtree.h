@@ -51,6 +51,10 @@ public:
 	// Shoot a ray from ray_start to ray_end and return the closest hit as a fractional value between 0 and 1. Returns 1 if no line was hit.
 	double RayTest(const DVector3 &ray_start, const DVector3 &ray_end);
 
+	// Any-hit test for a batch of 2D segments against the static lines. blocked[i] is set if segment i certainly crosses a line.
+	// Hits close to either segment's ends are not counted so the caller can leave those to a precise test.
+	void SegmentsBlocked(const DVector2 *starts, const DVector2 *ends, unsigned int count, bool *blocked);
+
 	const void *Nodes() const { return nodes.Data(); }
 	const void *Lines() const { return treelines.Data(); }
 	size_t NodesSize() const { return nodes.Size() * sizeof(AABBTreeNode); }
@@ -77,6 +81,10 @@ protected:
 	// Intersection test between a ray and a line segment
 	double IntersectRayLine(const DVector2 &ray_start, const DVector2 &ray_end, int line_index, const DVector2 &raydelta, double rayd, double raydist2);
 
+	// Tests up to 4 segments at once, see SegmentsBlocked
+	void SegmentPacketBlocked(const DVector2 *starts, const DVector2 *ends, unsigned int count, bool *blocked);
+	bool SegmentCrossesLine(const DVector2 &start, const DVector2 &end, int line_index);
+
 
 };
 
@@ -50,6 +50,120 @@
 //===========================================================================
 
 CVAR(Bool, gl_aalines, false, CVAR_ARCHIVE) 
+CVAR(Bool, gl_2dbatching, true, CVAR_ARCHIVE)
+
+//===========================================================================
+// 
+// @Cockatrice - Reorders 2D triangle commands so that compatible ones can
+// share a draw call even if other draws were submitted in between.
+//
+// A command may only move back to an earlier batch if it doesn't overlap
+// anything that was submitted between that batch and itself, so the result
+// looks exactly like painter's order. Everything else (stencil ops, lines,
+// points, shapes with their own buffers) is a barrier nothing moves across.
+// The merged batches get a freshly packed index list.
+//
+//===========================================================================
+
+struct F2DBatch
+{
+	unsigned Command;	// index into the output list
+	float Bounds[4];
+	bool Mergeable;
+};
+
+static void Batch2DCommands(F2DDrawer *drawer, TArray<F2DDrawer::RenderCommand> &out, TArray<int> &outindices)
+{
+	enum { MaxLookback = 64 };
+
+	auto &vertices = drawer->mVertices;
+	auto &indices = drawer->mIndices;
+	auto &commands = drawer->mData;
+
+	// Pass 1: sort the commands into batches, remembering which source commands each one gets.
+	TArray<F2DBatch> open;			// batches since the last barrier, in draw order
+	TArray<TArray<unsigned>> members;	// per output command
+	out.Clear();
+	outindices.Clear();
+
+	for (unsigned i = 0; i < commands.Size(); i++)
+	{
+		auto &cmd = commands[i];
+		bool barrier = cmd.isSpecial != SpecialDrawCommand::NotSpecial || cmd.shape2DBufInfo != nullptr || cmd.mType != F2DDrawer::DrawTypeTriangles;
+		if (barrier)
+		{
+			open.Clear();
+			out.Push(cmd);
+			members.Reserve(1);
+			continue;
+		}
+
+		float bounds[4] = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for (int j = cmd.mIndexIndex; j < cmd.mIndexIndex + cmd.mIndexCount; j++)
+		{
+			auto &v = vertices[indices[j]];
+			float x = v.x, y = v.y;
+			if (cmd.useTransform)
+			{
+				x = float(cmd.transform.Cells[0][0] * v.x + cmd.transform.Cells[0][1] * v.y + cmd.transform.Cells[0][2]);
+				y = float(cmd.transform.Cells[1][0] * v.x + cmd.transform.Cells[1][1] * v.y + cmd.transform.Cells[1][2]);
+			}
+			bounds[0] = min(bounds[0], x);
+			bounds[1] = min(bounds[1], y);
+			bounds[2] = max(bounds[2], x);
+			bounds[3] = max(bounds[3], y);
+		}
+
+		int target = -1;
+		for (int k = (int)open.Size() - 1; k >= 0 && k >= (int)open.Size() - MaxLookback; k--)
+		{
+			auto &batch = open[k];
+			if (batch.Mergeable && cmd.isCompatible(out[batch.Command]))
+			{
+				target = k;
+				break;
+			}
+			if (bounds[0] < batch.Bounds[2] && batch.Bounds[0] < bounds[2] && bounds[1] < batch.Bounds[3] && batch.Bounds[1] < bounds[3])
+			{
+				break;
+			}
+		}
+
+		if (target >= 0)
+		{
+			auto &batch = open[target];
+			batch.Bounds[0] = min(batch.Bounds[0], bounds[0]);
+			batch.Bounds[1] = min(batch.Bounds[1], bounds[1]);
+			batch.Bounds[2] = max(batch.Bounds[2], bounds[2]);
+			batch.Bounds[3] = max(batch.Bounds[3], bounds[3]);
+			members[batch.Command].Push(i);
+		}
+		else
+		{
+			unsigned index = out.Push(cmd);
+			members.Reserve(1);
+			members[index].Push(i);
+			open.Push({ index, { bounds[0], bounds[1], bounds[2], bounds[3] }, true });
+		}
+	}
+
+	// Pass 2: pack the indices of every batch together.
+	for (unsigned i = 0; i < out.Size(); i++)
+	{
+		if (members[i].Size() == 0) continue;
+		auto &cmd = out[i];
+		cmd.mIndexIndex = outindices.Size();
+		cmd.mIndexCount = 0;
+		for (auto m : members[i])
+		{
+			auto &src = commands[m];
+			if (src.mIndexCount <= 0) continue;
+			auto dest = outindices.Reserve(src.mIndexCount);
+			memcpy(&outindices[dest], &indices[src.mIndexIndex], src.mIndexCount * sizeof(int));
+			cmd.mIndexCount += src.mIndexCount;
+		}
+	}
+}
 
 void Draw2D(F2DDrawer* drawer, FRenderState& state)
 {
@@ -89,12 +203,26 @@ void Draw2D(F2DDrawer* drawer, FRenderState& state, int x, int y, int width, int
 			std::swap(v.color0.r, v.color0.b);
 		}
 	}
+	// Kept around so the arrays don't need to be reallocated every frame.
+	static TArray<F2DDrawer::RenderCommand> batchedcommands;
+	static TArray<int> batchedindices;
+	TArray<F2DDrawer::RenderCommand> *drawcommands = &commands;
+
 	F2DVertexBuffer vb;
-	vb.UploadData(&vertices[0], vertices.Size(), &indices[0], indices.Size());
+	if (gl_2dbatching)
+	{
+		Batch2DCommands(drawer, batchedcommands, batchedindices);
+		drawcommands = &batchedcommands;
+		vb.UploadData(&vertices[0], vertices.Size(), batchedindices.Size() > 0 ? &batchedindices[0] : nullptr, batchedindices.Size());
+	}
+	else
+	{
+		vb.UploadData(&vertices[0], vertices.Size(), &indices[0], indices.Size());
+	}
 	state.SetVertexBuffer(&vb);
 	state.EnableFog(false);
 
-	for(auto &cmd : commands)
+	for(auto &cmd : *drawcommands)
 	{
 		if (cmd.isSpecial != SpecialDrawCommand::NotSpecial)
 		{
@@ -248,6 +376,8 @@ void Draw2D(F2DDrawer* drawer, FRenderState& state, int x, int y, int width, int
 
 	}
 	state.SetScissor(-1, -1, -1, -1);
+	// Don't keep the shape buffers referenced beyond this frame.
+	batchedcommands.Clear();
 
 	state.SetRenderStyle(STYLE_Translucent);
 	state.SetVertexBuffer(screen->mVertexData);
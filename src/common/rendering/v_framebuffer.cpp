@@ -255,7 +255,6 @@ void DFrameBuffer::ScaleCoordsFromWindow(int16_t &x, int16_t &y)
 void DFrameBuffer::FPSLimit()
 {
 	using namespace std::chrono;
-	using namespace std::this_thread;
 
 	// @Cockatrice - Limit menu FPS to 200 regardless of setting
 	// Otherwise we can go NUTS on animated menus for no reason
@@ -274,29 +273,13 @@ void DFrameBuffer::FPSLimit()
 	}
 
 	uint64_t targetWakeTime = fpsLimitTime + 1'000'000 / maxfps;
+	int64_t timeToWait = targetWakeTime - duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
 
-	while (true)
+	if (timeToWait > 0 && timeToWait <= 1'000'000)
 	{
-		fpsLimitTime = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
-		int64_t timeToWait = targetWakeTime - fpsLimitTime;
-
-		if (timeToWait > 1'000'000 || timeToWait <= 0)
-		{
-			break;
-		}
-
-		if (timeToWait <= 2'000)
-		{
-			// We are too close to the deadline. OS sleep is not precise enough to wake us before it elapses.
-			// Yield execution and check time again.
-			sleep_for(nanoseconds(0));
-		}
-		else
-		{
-			// Sleep, but try to wake before deadline.
-			sleep_for(microseconds(timeToWait - 2'000));
-		}
+		I_PreciseSleep(timeToWait * 1'000);
 	}
+	fpsLimitTime = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
 }
 
 FMaterial* DFrameBuffer::CreateMaterial(FGameTexture* tex, int scaleflags)
@@ -543,9 +543,8 @@ void VkTexLoadThread::completeLoad() { currentImageID.store(0); }
 
 
 bool VkModelLoadThread::loadResource(VkModelLoadIn& input, VkModelLoadOut& output) {
-	FileReader reader = fileSystem.OpenFileReader(input.lump, FileSys::EReaderType::READER_NEW, 0);
-	output.data = reader.Read();
-	reader.Close();
+	// Parse and pack the geometry here, the main thread only has to copy it into the vertex buffer
+	output.packed = input.model->PackGeometry();
 
 	output.lump = input.lump;
 	output.model = input.model;
@@ -792,14 +791,12 @@ void VulkanRenderDevice::UpdateBackgroundCache(bool flush) {
 
 		if (modelOut.model->GetLoadState() != FModel::LOADING) {
 			statCollisions++;
-			modelOut.data.clear();
 			continue;
 		}
 
-		modelOut.model->LoadGeometry(&modelOut.data);
+		// If packing failed BuildVertexBuffer() will try again on the main thread
 		modelOut.model->SetLoadState(FModel::READY);
-		modelOut.data.clear();
-		statModelsLoaded++;
+		if (modelOut.packed) statModelsLoaded++;
 	}
 
 
@@ -1166,7 +1163,7 @@ void VulkanRenderDevice::PrequeueMaterial(FMaterial *mat, int translation)
 
 
 bool VulkanRenderDevice::BackgroundLoadModel(FModel* model) {
-	if (!model || model->GetLoadState() == FModel::READY || model->GetLumpNum() <= 0)
+	if (!model || model->GetLoadState() == FModel::READY || !model->SupportsBackgroundLoad())
 		return false;
 	if (model->GetLoadState() == FModel::LOADING)
 		return true;
@@ -85,7 +85,7 @@ struct VkModelLoadIn {
 
 struct VkModelLoadOut {
 	int lump = -1;
-	FileSys::FileData data;
+	bool packed = false;		// Geometry is staged and only needs to be uploaded
 	FModel* model = nullptr;
 };
 
@@ -38,7 +38,7 @@ struct RingBuffer {
 
 		T avg = (*this)[0];
 		numInputs = std::min(numInputs, IN_NUM);
-		numInputs = (int)std::min((long)numInputs, pos);
+		numInputs = (int)std::min((long)numInputs, pos + 1);
 
 		for (int x = 1; x < numInputs; x++) {
 			avg += (*this)[x];
@@ -36,7 +36,14 @@
 #include <chrono>
 #include <thread>
 #include <assert.h>
+#include <math.h>
+#ifdef __linux__
+#include <time.h>
+#include <errno.h>
+#endif
 #include "i_time.h"
+#include "TSQueue.h"
+#include "stats.h"
 
 //==========================================================================
 //
@@ -223,3 +230,90 @@ void I_ResetInputTime()
 	// Reset lastinputtime to current time.
 	lastinputtime = I_msTimeF();
 }
+
+//==========================================================================
+//
+// Frame pacing
+//
+// OS sleeps are only accurate to their scheduler's wakeup latency, so the
+// sleep ends early by the worst latency seen recently and the rest of the
+// wait is spent yielding. This keeps the CPU mostly idle while still
+// hitting the deadline, which matters on battery powered devices.
+//
+//==========================================================================
+
+static RingBuffer<int64_t, 32> SleepOvershoot;		// how much later than asked the OS sleep woke up
+static RingBuffer<int64_t, 128> PacingWakeError;	// how much later than the deadline we returned
+static RingBuffer<int64_t, 128> PacingSpinTime;
+
+static int64_t GetSleepMargin()
+{
+	int64_t margin = 0;
+	int count = (int)std::min<long>(SleepOvershoot.pos + 1, SleepOvershoot.length);
+	for (int i = 0; i < count; i++)
+	{
+		margin = std::max(margin, SleepOvershoot[i]);
+	}
+	// Start out conservative until there is some history.
+	if (count == 0) margin = 2'000'000;
+	return std::clamp<int64_t>(margin + 100'000, 100'000, 2'000'000);
+}
+
+static void SleepUntil(uint64_t deadline)
+{
+#ifdef __linux__
+	// steady_clock is CLOCK_MONOTONIC here, so an absolute sleep avoids drift from the call overhead.
+	timespec ts;
+	ts.tv_sec = time_t(deadline / 1'000'000'000);
+	ts.tv_nsec = long(deadline % 1'000'000'000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#else
+	uint64_t now = GetTimePoint();
+	if (deadline > now) std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now));
+#endif
+}
+
+int64_t I_PreciseSleep(uint64_t ns)
+{
+	const uint64_t deadline = GetTimePoint() + ns;
+	const int64_t margin = GetSleepMargin();
+
+	if ((int64_t)ns > margin)
+	{
+		const uint64_t wake = deadline - margin;
+		SleepUntil(wake);
+		SleepOvershoot.add(std::max<int64_t>(0, (int64_t)(GetTimePoint() - wake)));
+	}
+
+	uint64_t spinstart = GetTimePoint(), now;
+	while ((now = GetTimePoint()) < deadline)
+	{
+		std::this_thread::yield();
+	}
+
+	int64_t late = (int64_t)(now - deadline);
+	PacingWakeError.add(late);
+	PacingSpinTime.add((int64_t)(now - spinstart));
+	return late;
+}
+
+ADD_STAT(pacing)
+{
+	int count = (int)std::min<long>(PacingWakeError.pos + 1, PacingWakeError.length);
+	if (count == 0) return "No paced waits";
+
+	int64_t maxlate = 0;
+	double sumlate = 0, sumsq = 0, sumspin = 0;
+	for (int i = 0; i < count; i++)
+	{
+		int64_t late = PacingWakeError[i];
+		maxlate = std::max(maxlate, late);
+		sumlate += late;
+		sumsq += double(late) * late;
+		sumspin += PacingSpinTime[i];
+	}
+	double avg = sumlate / count;
+	double jitter = sqrt(std::max(0., sumsq / count - avg * avg));
+	return FStringf("Wake error avg %.1f us, max %.1f us, jitter %.1f us, spin %.1f us, sleep margin %.1f us",
+		avg / 1000., maxlate / 1000., jitter / 1000., sumspin / count / 1000., GetSleepMargin() / 1000.);
+}
@@ -41,6 +41,10 @@ uint64_t I_nsTime();
 // Reset the timer after a lengthy operation
 void I_ResetFrameTime();
 
+// Sleeps for the given time, using an OS sleep for most of it and spinning
+// only for the last bit. Returns how late it woke up in nanoseconds.
+int64_t I_PreciseSleep(uint64_t ns);
+
 // Return a decimal fraction to scale input operations at framerate
 double I_GetInputFrac();
 
@@ -0,0 +1,26 @@
+/*
+** workerpool.cpp
+** The shared worker thread pool
+**
+** Level loading, the renderer, the garbage collector and the sound code
+** all hand work to other threads. They used to do so through a pool of
+** their own each, every one of them sized to the core count, so busy
+** frames ran several times more threads than there are cores. All of
+** them share this one pool now.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+*/
+
+#include <thread>
+#include <algorithm>
+#include "workerpool.h"
+
+ctpl::thread_pool &WorkerPool()
+{
+	static ctpl::thread_pool pool(std::max(1, (int)std::thread::hardware_concurrency() - 1));
+	return pool;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "ctpl.h"
+
+// The engine's shared worker threads, one per core besides the main thread.
+// Jobs must never wait for other jobs in the pool, the thread that pushes
+// them has to be able to finish the work on its own.
+ctpl::thread_pool &WorkerPool();
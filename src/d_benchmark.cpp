@@ -0,0 +1,218 @@
+/*
+** d_benchmark.cpp
+** Headless playsim benchmark for automated performance tracking.
+**
+** Started with -benchmark [tics]. The game is initialized without a window,
+** render device or sound device (the dummy framebuffer from V_InitScreen is
+** never replaced), then the requested map or demo is run one tic after the
+** other as fast as possible. Input comes from a demo (-playdemo) or from
+** console commands (+exec with wait and +forward etc.), so runs are repeatable.
+** Per-subsystem timings are written as JSON to -benchmarkout or the console.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+*/
+
+#include "doomstat.h"
+#include "d_main.h"
+#include "d_net.h"
+#include "g_game.h"
+#include "g_levellocals.h"
+#include "c_console.h"
+#include "c_dispatch.h"
+#include "menu.h"
+#include "m_argv.h"
+#include "i_time.h"
+#include "stats.h"
+#include "printf.h"
+#include "version.h"
+#include "fs_files.h"
+#include "dobjgc.h"
+
+bool benchmarking;
+
+void G_BuildTiccmd (ticcmd_t* cmd);
+
+extern cycle_t ThinkCycles, ActionCycles, SightCycles, ParticleCycles, MovementCycles;
+extern cycle_t VMCycles[10];
+
+struct FBenchmarkStats
+{
+	enum
+	{
+		Tic,
+		Thinkers,
+		Actions,
+		Particles,
+		Sight,
+		Movement,
+		VM,
+		GC,
+		NumTimers
+	};
+
+	static constexpr const char *Names[NumTimers] = { "tic", "thinkers", "actions", "particles", "sight", "movement", "vm", "gc" };
+
+	double Total[NumTimers] = {};
+	double Peak[NumTimers] = {};
+	int Tics = 0;
+
+	void Add(int timer, double ms)
+	{
+		Total[timer] += ms;
+		if (ms > Peak[timer]) Peak[timer] = ms;
+	}
+};
+
+//==========================================================================
+//
+// Runs a single tic the same way D_DoomLoop does with -singletics.
+// Input only comes from the demo or the console command buffer.
+//
+//==========================================================================
+
+static void BenchmarkTic(FBenchmarkStats *stats)
+{
+	C_Ticker();
+	G_BuildTiccmd(&netcmds[consoleplayer][maketic % BACKUPTICS]);
+
+	if (stats == nullptr)
+	{
+		G_Ticker();
+		gametic++;
+		maketic++;
+		GC::CheckGC();
+		Net_NewMakeTic();
+		return;
+	}
+
+	// These are only reset by their stat pages which never get drawn here.
+	ParticleCycles.Reset();
+	MovementCycles.Reset();
+	VMCycles[0].Reset();
+
+	cycle_t tic, gc;
+	tic.Reset();
+	gc.Reset();
+
+	tic.Clock();
+	G_Ticker();
+	gametic++;
+	maketic++;
+	gc.Clock();
+	GC::CheckGC();
+	gc.Unclock();
+	tic.Unclock();
+	Net_NewMakeTic();
+
+	stats->Add(FBenchmarkStats::Tic, tic.TimeMS());
+	stats->Add(FBenchmarkStats::Thinkers, ThinkCycles.TimeMS());
+	stats->Add(FBenchmarkStats::Actions, ActionCycles.TimeMS());
+	stats->Add(FBenchmarkStats::Particles, ParticleCycles.TimeMS());
+	stats->Add(FBenchmarkStats::Sight, SightCycles.TimeMS());
+	stats->Add(FBenchmarkStats::Movement, MovementCycles.TimeMS());
+	stats->Add(FBenchmarkStats::VM, VMCycles[0].TimeMS());
+	stats->Add(FBenchmarkStats::GC, gc.TimeMS());
+	stats->Tics++;
+}
+
+//==========================================================================
+//
+// BenchmarkJson
+//
+//==========================================================================
+
+static FString BenchmarkJson(const FBenchmarkStats &stats, double seconds, bool demo)
+{
+	FString out;
+	int actors = 0;
+	for (auto Level : AllLevels())
+	{
+		auto it = Level->GetThinkerIterator<AActor>();
+		while (it.Next()) actors++;
+	}
+
+	out.AppendFormat("{\n");
+	out.AppendFormat("\t\"version\": \"%s\",\n", GetVersionString());
+	out.AppendFormat("\t\"map\": \"%s\",\n", primaryLevel->MapName.GetChars());
+	out.AppendFormat("\t\"input\": \"%s\",\n", demo ? "demo" : "script");
+	out.AppendFormat("\t\"tics\": %d,\n", stats.Tics);
+	out.AppendFormat("\t\"seconds\": %.3f,\n", seconds);
+	out.AppendFormat("\t\"tics_per_second\": %.2f,\n", seconds > 0 ? stats.Tics / seconds : 0.);
+	out.AppendFormat("\t\"actors\": %d,\n", actors);
+	out.AppendFormat("\t\"timers\": {\n");
+	for (int i = 0; i < FBenchmarkStats::NumTimers; i++)
+	{
+		out.AppendFormat("\t\t\"%s\": { \"total_ms\": %.3f, \"avg_ms\": %.4f, \"peak_ms\": %.4f }%s\n", FBenchmarkStats::Names[i],
+			stats.Total[i], stats.Tics > 0 ? stats.Total[i] / stats.Tics : 0., stats.Peak[i], i < FBenchmarkStats::NumTimers - 1 ? "," : "");
+	}
+	out.AppendFormat("\t}\n}\n");
+	return out;
+}
+
+//==========================================================================
+//
+// D_RunBenchmark
+//
+// Replaces D_DoomLoop when -benchmark is given. Timers nest, e.g. sight
+// and movement time is also part of thinkers, and VM time is spread over
+// all of them.
+//
+//==========================================================================
+
+int D_RunBenchmark()
+{
+	enum { MaxWarmupTics = TICRATE * 10, DefaultTics = TICRATE * 60 };
+
+	const char *v = Args->CheckValue("-benchmark");
+	int numtics = v != nullptr ? atoi(v) : 0;
+
+	// Let the deferred game start or demo playback load the level first.
+	for (int i = 0; gamestate != GS_LEVEL && gamestate != GS_TITLELEVEL; i++)
+	{
+		if (i == MaxWarmupTics)
+		{
+			Printf(PRINT_BOLD, "Benchmark: no level was started. Use +map, -warp or -playdemo.\n");
+			return 1;
+		}
+		BenchmarkTic(nullptr);
+	}
+	C_HideConsole();
+	M_ClearMenus();
+
+	const bool demo = demoplayback;
+	if (numtics <= 0 && !demo) numtics = DefaultTics;
+
+	Printf("Benchmark: running %s on %s\n", numtics > 0 ? FStringf("%d tics", numtics).GetChars() : "demo", primaryLevel->MapName.GetChars());
+
+	FBenchmarkStats stats;
+	uint64_t start = I_nsTime();
+	while (numtics <= 0 || stats.Tics < numtics)
+	{
+		BenchmarkTic(&stats);
+		if (demo && !demoplayback) break;
+	}
+	double seconds = (I_nsTime() - start) * 1e-9;
+
+	FString json = BenchmarkJson(stats, seconds, demo);
+	v = Args->CheckValue("-benchmarkout");
+	if (v != nullptr)
+	{
+		FileWriter *fw = FileWriter::Open(v);
+		if (fw == nullptr)
+		{
+			Printf(PRINT_BOLD, "Benchmark: unable to write %s\n", v);
+			return 1;
+		}
+		fw->Write(json.GetChars(), json.Len());
+		delete fw;
+	}
+	else
+	{
+		Printf(PRINT_NONOTIFY, "%s", json.GetChars());
+	}
+	return 0;
+}
@@ -3316,6 +3316,12 @@ static int D_InitGame(const FIWADInfo* iwad_info, std::vector<std::string>& allw
 		use_staticrng = true;
 		if (!batchrun) Printf("D_DoomInit: Static RNGseed %d set.\n", rngseed);
 	}
+	else if (benchmarking)
+	{
+		// Benchmark runs must be repeatable.
+		rngseed = staticrngseed = 0;
+		use_staticrng = true;
+	}
 	else
 	{
 		rngseed = I_MakeRNGSeed();
@@ -3417,7 +3423,7 @@ static int D_InitGame(const FIWADInfo* iwad_info, std::vector<std::string>& allw
 	int max_progress = TexMan.GuesstimateNumTextures();
 	if (writeCache) max_progress *= 2;	// If we are writing textures, we need to double the estimated time so we get actual progress
 	int per_shader_progress = 0;//screen->GetShaderCount()? (max_progress / 10 / screen->GetShaderCount()) : 0;
-	bool nostartscreen = batchrun || restart || Args->CheckParm("-join") || Args->CheckParm("-host") || Args->CheckParm("-norun");
+	bool nostartscreen = batchrun || benchmarking || restart || Args->CheckParm("-join") || Args->CheckParm("-host") || Args->CheckParm("-norun");
 
 	if (GameStartupInfo.Type == FStartupInfo::DefaultStartup)
 	{
@@ -3458,7 +3464,8 @@ static int D_InitGame(const FIWADInfo* iwad_info, std::vector<std::string>& allw
 		vk_max_transfer_threads = min(1, (int)vk_max_transfer_threads);
 	}
 
-	if (!restart)
+	// The benchmark keeps the dummy framebuffer so no window or render device is ever created.
+	if (!restart && !benchmarking)
 		V_Init2();
 
 	CLOCK_START
@@ -3806,7 +3813,7 @@ static int D_InitGame(const FIWADInfo* iwad_info, std::vector<std::string>& allw
 					}
 					else
 					{
-						if (multiplayer || cl_nointros || Args->CheckParm("-nointro"))
+						if (multiplayer || cl_nointros || benchmarking || Args->CheckParm("-nointro"))
 						{
 							D_StartTitle();
 						}
@@ -3935,6 +3942,13 @@ static int D_DoomMain_Internal (void)
 		Printf("\n");
 	}
 
+	// @Cockatrice - Headless playsim benchmark, see d_benchmark.cpp
+	if (Args->CheckParm("-benchmark"))
+	{
+		benchmarking = true;
+		nosound = true;
+	}
+
 	Printf("%s version %s\n", GAMENAME, GetVersionString());
 
 	extern void D_ConfirmSendStats();
@@ -4005,6 +4019,11 @@ static int D_DoomMain_Internal (void)
 		
 		statDatabase.update();	// @Cockatrice - Do at least one update before the game loop
 
+		if (benchmarking)
+		{
+			return D_RunBenchmark();
+		}
+
 		D_DoAnonStats();
 		I_UpdateWindowTitle();
 		I_FocusWindow();
@@ -54,6 +54,10 @@ struct CRestartException
 
 void D_Display ();
 
+// Headless playsim benchmark (-benchmark)
+extern bool benchmarking;
+int D_RunBenchmark();
+
 
 //
 // BASE LEVEL
@@ -72,6 +72,7 @@
 #include "d_main.h"
 #include "i_interface.h"
 #include "savegamemanager.h"
+#include "TSQueue.h"
 
 EXTERN_CVAR (Int, disableautosave)
 EXTERN_CVAR (Int, autosavecount)
@@ -1831,37 +1832,26 @@ void D_QuitNetGame (void)
 
 CVAR(Bool, r_ticstability, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
 
-static uint64_t stabilityticduration = 0;
+static RingBuffer<uint64_t, 8> stabilityticdurations;
 static uint64_t stabilitystarttime = 0;
 
 static void TicStabilityWait()
 {
-	using namespace std::chrono;
-	using namespace std::this_thread;
-
-	if (!r_ticstability)
+	if (!r_ticstability || stabilityticdurations.pos < 0)
 		return;
 
-	uint64_t start = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
-	while (true)
-	{
-		uint64_t cur = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
-		if (cur - start > stabilityticduration)
-			break;
-	}
+	// Predict the tic cost from the last few so a single hitch doesn't stall the next frames.
+	I_PreciseSleep(stabilityticdurations.getAverage(stabilityticdurations.length));
 }
 
 static void TicStabilityBegin()
 {
-	using namespace std::chrono;
-	stabilitystarttime = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+	stabilitystarttime = I_nsTime();
 }
 
 static void TicStabilityEnd()
 {
-	using namespace std::chrono;
-	uint64_t stabilityendtime = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
-	stabilityticduration = min(stabilityendtime - stabilitystarttime, (uint64_t)1'000'000);
+	stabilityticdurations.add(min(I_nsTime() - stabilitystarttime, (uint64_t)1'000'000'000));
 }
 
 //
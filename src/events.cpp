@@ -269,6 +269,16 @@ void EventManager::CallOnRegister()
 	{
 		handler->OnRegister();
 	}
+	UpdateSubscriptions();
+}
+
+void EventManager::UpdateSubscriptions()
+{
+	ThingEventSubscribers = 0;
+	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
+	{
+		ThingEventSubscribers |= handler->GetThingEventMask();
+	}
 }
 
 bool EventManager::RegisterHandler(DStaticEventHandler* handler)
@@ -337,6 +347,7 @@ bool EventManager::RegisterHandler(DStaticEventHandler* handler)
 		handler->ObjectFlags |= OF_Transient;
 	}
 
+	UpdateSubscriptions();
 	return true;
 }
 
@@ -370,6 +381,7 @@ bool EventManager::UnregisterHandler(DStaticEventHandler* handler)
 		LastEventHandler = handler->prev;
 		GC::WriteBarrier(handler->prev);
 	}
+	UpdateSubscriptions();
 	if (handler->IsStatic())
 	{
 		handler->ObjectFlags &= ~OF_Transient;
@@ -633,6 +645,7 @@ void EventManager::Shutdown()
 		handler->Destroy();
 	}
 	FirstEventHandler = LastEventHandler = nullptr;
+	ThingEventSubscribers = 0;
 }
 
 #define DEFINE_EVENT_LOOPER(name, play) void EventManager::name() \
@@ -740,8 +753,12 @@ void EventManager::WorldThingSpawned(AActor* actor)
 
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingSpawned(actor);
 
+	if (!(ThingEventSubscribers & THINGEV_Spawned))
+		return;
+
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingSpawned(actor);
+		if (handler->WantsThingEvent(THINGEV_Spawned, actor))
+			handler->WorldThingSpawned(actor);
 }
 
 void EventManager::WorldThingDied(AActor* actor, AActor* inflictor)
@@ -752,8 +769,12 @@ void EventManager::WorldThingDied(AActor* actor, AActor* inflictor)
 
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingDied(actor, inflictor);
 
+	if (!(ThingEventSubscribers & THINGEV_Died))
+		return;
+
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingDied(actor, inflictor);
+		if (handler->WantsThingEvent(THINGEV_Died, actor))
+			handler->WorldThingDied(actor, inflictor);
 }
 
 void EventManager::WorldThingGround(AActor* actor, FState* st)
@@ -764,8 +785,12 @@ void EventManager::WorldThingGround(AActor* actor, FState* st)
 
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingGround(actor, st);
 
+	if (!(ThingEventSubscribers & THINGEV_Ground))
+		return;
+
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingGround(actor, st);
+		if (handler->WantsThingEvent(THINGEV_Ground, actor))
+			handler->WorldThingGround(actor, st);
 }
 
 void EventManager::WorldThingRevived(AActor* actor)
@@ -776,8 +801,12 @@ void EventManager::WorldThingRevived(AActor* actor)
 
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingRevived(actor);
 
+	if (!(ThingEventSubscribers & THINGEV_Revived))
+		return;
+
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingRevived(actor);
+		if (handler->WantsThingEvent(THINGEV_Revived, actor))
+			handler->WorldThingRevived(actor);
 }
 
 void EventManager::WorldThingDamaged(AActor* actor, AActor* inflictor, AActor* source, int damage, FName mod, int flags, DAngle angle)
@@ -788,8 +817,12 @@ void EventManager::WorldThingDamaged(AActor* actor, AActor* inflictor, AActor* s
 
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingDamaged(actor, inflictor, source, damage, mod, flags, angle);
 
+	if (!(ThingEventSubscribers & THINGEV_Damaged))
+		return;
+
 	for (DStaticEventHandler* handler = FirstEventHandler; handler; handler = handler->next)
-		handler->WorldThingDamaged(actor, inflictor, source, damage, mod, flags, angle);
+		if (handler->WantsThingEvent(THINGEV_Damaged, actor))
+			handler->WorldThingDamaged(actor, inflictor, source, damage, mod, flags, angle);
 }
 
 void EventManager::WorldThingDestroyed(AActor* actor)
@@ -802,8 +835,12 @@ void EventManager::WorldThingDestroyed(AActor* actor)
 	if (!(actor->ObjectFlags & OF_Spawned))
 		return;
 
-	for (DStaticEventHandler* handler = LastEventHandler; handler; handler = handler->prev)
-		handler->WorldThingDestroyed(actor);
+	if (ThingEventSubscribers & THINGEV_Destroyed)
+	{
+		for (DStaticEventHandler* handler = LastEventHandler; handler; handler = handler->prev)
+			if (handler->WantsThingEvent(THINGEV_Destroyed, actor))
+				handler->WorldThingDestroyed(actor);
+	}
 
 	if (ShouldCallStatic(true)) staticEventManager.WorldThingDestroyed(actor);
 }
@@ -1641,6 +1678,24 @@ DEFINE_ACTION_FUNCTION(DStaticEventHandler, SetOrder)
 	return 0;
 }
 
+DEFINE_ACTION_FUNCTION(DStaticEventHandler, AddThingFilter)
+{
+	PARAM_SELF_PROLOGUE(DStaticEventHandler);
+	PARAM_CLASS_NOT_NULL(cls, AActor);
+
+	if (self->ThingFilters.Find(cls) == self->ThingFilters.Size())
+		self->ThingFilters.Push(cls);
+	return 0;
+}
+
+DEFINE_ACTION_FUNCTION(DStaticEventHandler, ClearThingFilters)
+{
+	PARAM_SELF_PROLOGUE(DStaticEventHandler);
+
+	self->ThingFilters.Clear();
+	return 0;
+}
+
 DEFINE_ACTION_FUNCTION(DEventHandler, SendNetworkCommand)
 {
 	PARAM_PROLOGUE;
@@ -1728,6 +1783,36 @@ static bool isEmptyInt(VMFunction *func)
 //
 // ===========================================
 
+// Collect the thing events this handler's class actually implements.
+int DStaticEventHandler::GetThingEventMask()
+{
+	if (ThingEventMask < 0)
+	{
+		int mask = 0;
+#define CHECK_THING_EVENT(name, bit) { IFVIRTUAL(DStaticEventHandler, name) { if (!isEmpty(func)) mask |= bit; } }
+		CHECK_THING_EVENT(WorldThingSpawned, THINGEV_Spawned)
+		CHECK_THING_EVENT(WorldThingDied, THINGEV_Died)
+		CHECK_THING_EVENT(WorldThingGround, THINGEV_Ground)
+		CHECK_THING_EVENT(WorldThingRevived, THINGEV_Revived)
+		CHECK_THING_EVENT(WorldThingDamaged, THINGEV_Damaged)
+		CHECK_THING_EVENT(WorldThingDestroyed, THINGEV_Destroyed)
+#undef CHECK_THING_EVENT
+		ThingEventMask = mask;
+	}
+	return ThingEventMask;
+}
+
+bool DStaticEventHandler::WantsThingEvent(int event, AActor* actor)
+{
+	if (!(GetThingEventMask() & event)) return false;
+	if (ThingFilters.Size() == 0) return true;
+	for (auto cls : ThingFilters)
+	{
+		if (actor->IsKindOf(cls)) return true;
+	}
+	return false;
+}
+
 void DStaticEventHandler::OnRegister()
 {
 	IFVIRTUAL(DStaticEventHandler, OnRegister)
@@ -20,6 +20,18 @@ enum class EventHandlerType
 	PerMap
 };
 
+// Events that are sent for every actor. Handlers that don't override them
+// (or filter out the actor's class) are skipped without a VM call.
+enum EThingEvent
+{
+	THINGEV_Spawned = 1,
+	THINGEV_Died = 2,
+	THINGEV_Ground = 4,
+	THINGEV_Revived = 8,
+	THINGEV_Damaged = 16,
+	THINGEV_Destroyed = 32,
+};
+
 enum ENetCmd
 {
 	NET_INT8 = 1,
@@ -272,6 +284,14 @@ public:
 	bool IsUiProcessor;
 	bool RequireMouse;
 
+	// Thing event subscriptions. The mask is taken from the overridden virtuals once,
+	// the filter restricts them to the listed actor classes (empty = all).
+	int ThingEventMask = -1;
+	TArray<PClass*> ThingFilters;
+
+	int GetThingEventMask();
+	bool WantsThingEvent(int event, AActor* actor);
+
 	// serialization handler. let's keep it here so that I don't get lost in serialized/not serialized fields
 	void Serialize(FSerializer& arc) override
 	{
@@ -292,6 +312,7 @@ public:
 		arc("Order", Order);
 		arc("IsUiProcessor", IsUiProcessor);
 		arc("RequireMouse", RequireMouse);
+		arc("ThingFilters", ThingFilters);
 	}
 
 	// destroy handler. this unlinks EventHandler from the list automatically.
@@ -466,6 +487,7 @@ struct EventManager
 	FLevelLocals *Level = nullptr;
 	DStaticEventHandler* FirstEventHandler = nullptr;
 	DStaticEventHandler* LastEventHandler = nullptr;
+	int ThingEventSubscribers = 0;	// union of all handlers' thing event masks
 
 	EventManager() = default;
 	EventManager(FLevelLocals *l) { Level = l; }
@@ -486,6 +508,8 @@ struct EventManager
 	void InitStaticHandlers(FLevelLocals *l, bool map);
 	// shutdown handlers
 	void Shutdown();
+	// recollect the thing events any handler is listening to
+	void UpdateSubscriptions();
 
 	// after the engine is done creating data
 	void OnEngineInitialize();
@@ -590,6 +614,7 @@ struct EventManager
 		{
 			existinghandler->owner = this;
 		}
+		UpdateSubscriptions();
 	}
 
 };
@@ -49,6 +49,8 @@ CVAR (Bool, cl_spreaddecals, true, CVAR_ARCHIVE)
 CVAR(Bool, var_pushers, true, CVAR_SERVERINFO);
 CVAR(Bool, gl_cachenodes, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 CVAR(Float, gl_cachetime, 0.6f, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+CVAR(Bool, gl_cachelevels, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
+CVAR(Bool, gl_multithreadnodes, true, CVAR_ARCHIVE|CVAR_GLOBALCONFIG)
 CVAR(Bool, alwaysapplydmflags, false, CVAR_SERVERINFO);
 
 // [RH] Feature control cvars
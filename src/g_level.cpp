@@ -1862,6 +1862,7 @@ FLevelLocals::FLevelLocals() : Behaviors(this), tagManager(this)
 FLevelLocals::~FLevelLocals()
 {
 	if (localEventManager) delete localEventManager;
+	S_ResetOcclusion();
 	if (aabbTree) delete aabbTree;
 }
 
@@ -2305,8 +2306,7 @@ size_t DSectorMarker::PropagateMark()
 	if (moretodo)
 	{
 		Black2Gray();
-		GCNext = GC::Gray;
-		GC::Gray = this;
+		GC::PushGray(this);
 	}
 	return marked;
 }
@@ -2,6 +2,7 @@
 #define __P_BLOCKMAP_H
 
 #include "doomtype.h"
+#include "tarray.h"
 
 class AActor;
 
@@ -15,6 +16,7 @@ struct FBlockNode
 	FBlockNode *NextActor;			// next actor in this block
 	FBlockNode **PrevBlock;			// previous block this actor is in
 	FBlockNode *NextBlock;			// next block this actor is in
+	int ThingIndex;					// index into the block's FBlockThing array
 
 	static FBlockNode *Create (AActor *who, int x, int y, int group = -1);
 	void Release ();
@@ -22,6 +24,26 @@ struct FBlockNode
 	static FBlockNode *FreeBlocks;
 };
 
+// Flat copy of a block's thing chain so it can be scanned without walking
+// the nodes. Kept in the same order as the chain, but reversed, i.e. the
+// most recently linked actor is last. The position is kept in sync by
+// AActor's position setters, the radius by UpdateBlockThings.
+// Unlinked things leave an entry with Me == nullptr behind, so unlinking
+// doesn't have to move the rest of the block.
+struct FBlockThing
+{
+	AActor *Me;
+	FBlockNode *Node;
+	double X, Y;
+	double Radius;
+};
+
+struct FBlockThingList
+{
+	TArray<FBlockThing> Things;
+	unsigned Dead = 0;				// unlinked entries still in Things
+};
+
 // BLOCKMAP
 // Created from axis aligned bounding box
 // of the map, a rectangular array of
@@ -40,6 +62,8 @@ struct FBlockmap
 	double				bmaporgx;
 	double				bmaporgy;		// origin of block map
 	FBlockNode**		blocklinks; 	// for thing chains
+	FBlockThingList*	blockthings = nullptr;	// flat copies of the thing chains
+	TArray<int>			deadthings;				// blocks with unlinked entries to compact
 
 	// mapblocks are used to check movement
 	// against lines and things
@@ -84,8 +108,18 @@ struct FBlockmap
 			delete[] blocklinks;
 			blocklinks = nullptr;
 		}
+		if (blockthings != nullptr)
+		{
+			delete[] blockthings;
+			blockthings = nullptr;
+		}
+		deadthings.Clear();
 	}
 
+	void AddThing(FBlockNode *node);
+	void RemoveThing(FBlockNode *node);
+	void CompactThings();
+
 	~FBlockmap()
 	{
 		Clear();
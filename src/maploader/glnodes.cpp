@@ -58,6 +58,7 @@
 
 EXTERN_CVAR(Bool, gl_cachenodes)
 EXTERN_CVAR(Float, gl_cachetime)
+EXTERN_CVAR(Bool, gl_cachelevels)
 
 // fixed 32 bit gl_vert format v2.0+ (glBsp 1.91)
 struct mapglvertex_t
@@ -993,7 +994,7 @@ bool MapLoader::CheckNodes(MapData * map, bool rebuilt, int buildtime)
 typedef TArray<uint8_t> MemFile;
 
 
-static FString CreateCacheName(MapData *map, bool create)
+static FString CreateCacheName(MapData *map, bool create, const char *ext = ".gzc")
 {
 	FString path = M_GetCachePath(create);
 	FString lumpname = fileSystem.GetFileFullPath(map->lumpnum).c_str();
@@ -1003,7 +1004,7 @@ static FString CreateCacheName(MapData *map, bool create)
 
 	lumpname.ReplaceChars('/', '%');
 	lumpname.ReplaceChars(':', '$');
-	path << '/' << lumpname.Right((ptrdiff_t)lumpname.Len() - separator - 1) << ".gzc";
+	path << '/' << lumpname.Right((ptrdiff_t)lumpname.Len() - separator - 1) << ext;
 	return path;
 }
 
@@ -1192,6 +1193,226 @@ bool MapLoader::CheckCachedNodes(MapData *map)
 	return true;
 }
 
+//==========================================================================
+//
+// Level cache
+//
+// Stores data that is expensive to generate from the processed level
+// geometry so that it can be copied back in on the next visit: the
+// generated blockmap ('BMAP'), REJECT ('RJC2') and the sound zones ('ZONE').
+// The remaining geometry passes (line groups, render sectors, sections) are
+// linear and build pointer tables, so rebuilding them is cheaper than
+// validating a cached copy. The file sits next to the node cache and is keyed by
+// the map's checksum plus a hash of the final line geometry and zone
+// boundaries, so that compatibility fixes or postprocessing changes invalidate it.
+//
+// Layout: "LVLC", version, geometry key, line/sector count, checksum,
+// uncompressed size, then a zlib stream of (id, size, data) chunks.
+//
+//==========================================================================
+
+enum
+{
+	LEVELCACHE_VERSION = 2,
+	LEVELCACHE_HEADER = 4 + 4 + 4 + 4 + 4 + 16 + 4,
+};
+
+static uint32_t ReadLong(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint32_t MapLoader::GetLevelCacheKey()
+{
+	uint32_t key = crc32(0, nullptr, 0);
+	for (auto &line : Level->lines)
+	{
+		int32_t data[7] =
+		{
+			LittleLong(line.v1->fixX()), LittleLong(line.v1->fixY()),
+			LittleLong(line.v2->fixX()), LittleLong(line.v2->fixY()),
+			LittleLong(line.frontsector ? Index(line.frontsector) : -1),
+			LittleLong(line.backsector ? Index(line.backsector) : -1),
+			LittleLong(int32_t(line.flags & ML_ZONEBOUNDARY))
+		};
+		key = crc32(key, (const uint8_t *)data, sizeof(data));
+	}
+	return key;
+}
+
+//==========================================================================
+//
+// Upper bound for the uncompressed size of a level cache that matches
+// this map. The cache only holds the generated blockmap, REJECT and the
+// zones, so anything larger than all of them at their worst can only be garbage.
+//
+//==========================================================================
+
+uint64_t MapLoader::GetLevelCacheLimit()
+{
+	uint64_t limit = 0;
+
+	if (Level->vertexes.Size() > 0)
+	{
+		// Same extents as CreateBlockMap
+		double dminx, dmaxx, dminy, dmaxy;
+		dminx = dmaxx = Level->vertexes[0].fX();
+		dminy = dmaxy = Level->vertexes[0].fY();
+		for (auto &vert : Level->vertexes)
+		{
+			dminx = min(dminx, vert.fX());
+			dmaxx = max(dmaxx, vert.fX());
+			dminy = min(dminy, vert.fY());
+			dmaxy = max(dmaxy, vert.fY());
+		}
+		uint64_t width = uint64_t((int(dmaxx) - int(dminx)) >> 7) + 1;
+		uint64_t height = uint64_t((int(dmaxy) - int(dminy)) >> 7) + 1;
+
+		// Header, one offset plus the 0 and -1 markers per block, and every line crossing at most width + height blocks
+		uint64_t blockmap = 4 + width * height * 3 + Level->lines.Size() * (width + height);
+		limit += 8 + blockmap * 4;
+	}
+
+	uint64_t sectors = Level->sectors.Size();
+	limit += 8 + (sectors * sectors + 7) / 8;
+	limit += 8 + 4 + sectors * 2;
+	return limit;
+}
+
+void MapLoader::OpenLevelCache(MapData *map)
+{
+	LevelCache.Clear();
+	LevelCacheDirty = false;
+	if (!gl_cachelevels || Level->maptype == MAPTYPE_BUILD) return;
+
+	LevelCacheKey = GetLevelCacheKey();
+
+	FString path = CreateCacheName(map, false, ".gzl");
+	FileReader fr;
+
+	if (!fr.OpenFile(path.GetChars())) return;
+
+	uint8_t header[LEVELCACHE_HEADER];
+	uint8_t md5map[16];
+	if (fr.Read(header, LEVELCACHE_HEADER) != LEVELCACHE_HEADER) return;
+	if (memcmp(header, "LVLC", 4)) return;
+	if (ReadLong(header + 4) != LEVELCACHE_VERSION) return;
+	if (ReadLong(header + 8) != LevelCacheKey) return;
+	if (ReadLong(header + 12) != Level->lines.Size()) return;
+	if (ReadLong(header + 16) != Level->sectors.Size()) return;
+	map->GetChecksum(md5map);
+	if (memcmp(header + 20, md5map, 16)) return;
+
+	uLongf outlen = ReadLong(header + 36);
+	if (outlen > GetLevelCacheLimit())
+	{
+		DPrintf(DMSG_WARNING, "Level cache %s is damaged\n", path.GetChars());
+		return;
+	}
+	auto compressed = fr.Read();
+	TArray<uint8_t> data(outlen, true);
+	if (uncompress(data.Data(), &outlen, compressed.bytes(), (uLong)compressed.size()) != Z_OK || outlen != data.Size())
+	{
+		DPrintf(DMSG_WARNING, "Level cache %s is damaged\n", path.GetChars());
+		return;
+	}
+
+	unsigned pos = 0;
+	while (pos + 8 <= data.Size())
+	{
+		uint32_t id = ReadLong(&data[pos]);
+		uint32_t size = ReadLong(&data[pos + 4]);
+		pos += 8;
+		if (size > data.Size() - pos)
+		{
+			LevelCache.Clear();
+			return;
+		}
+		auto &chunk = LevelCache[LevelCache.Reserve(1)];
+		chunk.id = id;
+		chunk.data.Resize(size);
+		memcpy(chunk.data.Data(), &data[pos], size);
+		pos += size;
+	}
+}
+
+TArray<uint8_t> *MapLoader::FindLevelCacheChunk(uint32_t id)
+{
+	for (auto &chunk : LevelCache)
+	{
+		if (chunk.id == id) return &chunk.data;
+	}
+	return nullptr;
+}
+
+void MapLoader::StoreLevelCacheChunk(uint32_t id, TArray<uint8_t> &data)
+{
+	if (!gl_cachelevels || Level->maptype == MAPTYPE_BUILD) return;
+
+	auto existing = FindLevelCacheChunk(id);
+	if (existing == nullptr)
+	{
+		auto &chunk = LevelCache[LevelCache.Reserve(1)];
+		chunk.id = id;
+		existing = &chunk.data;
+	}
+	*existing = std::move(data);
+	LevelCacheDirty = true;
+}
+
+void MapLoader::SaveLevelCache(MapData *map)
+{
+	if (!LevelCacheDirty) return;
+	LevelCacheDirty = false;
+
+	MemFile chunks;
+	for (auto &chunk : LevelCache)
+	{
+		WriteLong(chunks, chunk.id);
+		WriteLong(chunks, chunk.data.Size());
+		chunks.Append(chunk.data);
+	}
+
+	uLongf outlen = compressBound(chunks.Size());
+	TArray<Bytef> compressed(LEVELCACHE_HEADER + outlen, true);
+	if (compress(compressed.Data() + LEVELCACHE_HEADER, &outlen, chunks.Data(), chunks.Size()) != Z_OK)
+	{
+		return;
+	}
+
+	MemFile header;
+	memcpy(&header[header.Reserve(4)], "LVLC", 4);
+	WriteLong(header, LEVELCACHE_VERSION);
+	WriteLong(header, LevelCacheKey);
+	WriteLong(header, Level->lines.Size());
+	WriteLong(header, Level->sectors.Size());
+	int v = header.Reserve(16);
+	map->GetChecksum(&header[v]);
+	WriteLong(header, chunks.Size());
+	memcpy(compressed.Data(), header.Data(), LEVELCACHE_HEADER);
+
+	// Write to a temp file and move it into place, so a crash or a full disk never leaves a truncated cache behind.
+	FString path = CreateCacheName(map, true, ".gzl");
+	FString temp = path + ".tmp";
+	FileWriter *fw = FileWriter::Open(temp.GetChars());
+
+	if (fw != nullptr)
+	{
+		const size_t length = outlen + LEVELCACHE_HEADER;
+		bool ok = fw->Write(compressed.Data(), length) == length;
+		delete fw;
+		if (!ok || !RenameFile(temp.GetChars(), path.GetChars()))
+		{
+			Printf("Error saving level cache to file %s\n", path.GetChars());
+			RemoveFile(temp.GetChars());
+		}
+	}
+	else
+	{
+		Printf("Cannot open level cache file %s for writing\n", path.GetChars());
+	}
+}
+
 UNSAFE_CCMD(clearnodecache)
 {
 	FileSys::FileList list;
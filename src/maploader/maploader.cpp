@@ -84,6 +84,7 @@
 #include "texturemanager.h"
 #include "hw_vertexbuilder.h"
 #include "version.h"
+#include "d_main.h"
 #include "fs_decompress.h"
 
 enum
@@ -393,12 +394,52 @@ void MapLoader::FloodZones ()
 	int z = 0, i;
 	ReverbContainer *reverb;
 
-	for (auto &sec : Level->sectors)
+	// The zones only depend on the sector connectivity and the zone boundary flags, both of which are part of the level cache key.
+	// Layout: zone count followed by a 16 bit zone number per sector.
+	const unsigned numsectors = Level->sectors.Size();
+	auto cached = FindLevelCacheChunk(MAKE_ID('Z', 'O', 'N', 'E'));
+	if (cached != nullptr && cached->Size() == 4 + numsectors * 2)
+	{
+		const uint8_t *data = cached->Data();
+		z = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+		for (unsigned s = 0; s < numsectors; s++)
+		{
+			int zone = data[4 + s * 2] | (data[5 + s * 2] << 8);
+			if (zone >= z)
+			{
+				z = -1;
+				break;
+			}
+			Level->sectors[s].ZoneNumber = zone;
+		}
+		if (z < 0)
+		{
+			z = 0;
+			for (auto &sec : Level->sectors) sec.ZoneNumber = 0xFFFF;
+		}
+	}
+
+	if (z == 0)
 	{
-		if (sec.ZoneNumber == 0xFFFF)
+		for (auto &sec : Level->sectors)
 		{
-			FloodZone (&sec, z++);
+			if (sec.ZoneNumber == 0xFFFF)
+			{
+				FloodZone (&sec, z++);
+			}
+		}
+
+		TArray<uint8_t> data(4 + numsectors * 2, true);
+		data[0] = uint8_t(z);
+		data[1] = uint8_t(z >> 8);
+		data[2] = uint8_t(z >> 16);
+		data[3] = uint8_t(z >> 24);
+		for (unsigned s = 0; s < numsectors; s++)
+		{
+			data[4 + s * 2] = uint8_t(Level->sectors[s].ZoneNumber);
+			data[5 + s * 2] = uint8_t(Level->sectors[s].ZoneNumber >> 8);
 		}
+		StoreLevelCacheChunk(MAKE_ID('Z', 'O', 'N', 'E'), data);
 	}
 	Level->Zones.Resize(z);
 	reverb = S_FindEnvironment(Level->DefaultEnvironment);
@@ -2317,7 +2358,7 @@ static void CreatePackedBlockmap (TArray<int> &BlockMap, TArray<int> *blocks, in
 }
 
 
-void MapLoader::CreateBlockMap ()
+unsigned MapLoader::CreateBlockMap ()
 {
 	enum
 	{
@@ -2334,7 +2375,7 @@ void MapLoader::CreateBlockMap ()
 	int line;
 
 	if (Level->vertexes.Size() == 0)
-		return;
+		return 0;
 
 	// Find map extents for the blockmap
 	dminx = dmaxx = Level->vertexes[0].fX();
@@ -2489,10 +2530,53 @@ void MapLoader::CreateBlockMap ()
 	{
 		Level->blockmap.blockmaplump[ii] = BlockMap[ii];
 	}
+	return BlockMap.Size();
 }
 
 
 
+//===========================================================================
+//
+// Fetches a previously generated blockmap from the level cache or
+// creates a new one and stores it there.
+//
+//===========================================================================
+
+void MapLoader::GenerateBlockMap()
+{
+	auto cached = FindLevelCacheChunk(MAKE_ID('B', 'M', 'A', 'P'));
+	if (cached != nullptr && cached->Size() >= 16 && (cached->Size() & 3) == 0)
+	{
+		unsigned count = cached->Size() / 4;
+		const uint32_t *data = (const uint32_t *)cached->Data();
+		Level->blockmap.blockmaplump = new int[count];
+		for (unsigned i = 0; i < count; i++)
+		{
+			Level->blockmap.blockmaplump[i] = LittleLong(data[i]);
+		}
+		if (Level->blockmap.VerifyBlockMap(count, Level->lines.Size()))
+		{
+			return;
+		}
+		delete[] Level->blockmap.blockmaplump;
+		Level->blockmap.blockmaplump = nullptr;
+	}
+
+	DPrintf (DMSG_SPAMMY, "Generating BLOCKMAP\n");
+	unsigned count = CreateBlockMap ();
+
+	if (count > 0)
+	{
+		TArray<uint8_t> data(count * 4, true);
+		uint32_t *out = (uint32_t *)data.Data();
+		for (unsigned i = 0; i < count; i++)
+		{
+			out[i] = LittleLong((uint32_t)Level->blockmap.blockmaplump[i]);
+		}
+		StoreLevelCacheChunk(MAKE_ID('B', 'M', 'A', 'P'), data);
+	}
+}
+
 //===========================================================================
 //
 // P_VerifyBlockMap
@@ -2596,8 +2680,7 @@ void MapLoader::LoadBlockMap (MapData * map)
 		Args->CheckParm("-blockmap")
 		)
 	{
-		DPrintf (DMSG_SPAMMY, "Generating BLOCKMAP\n");
-		CreateBlockMap ();
+		GenerateBlockMap();
 	}
 	else
 	{
@@ -2626,8 +2709,9 @@ void MapLoader::LoadBlockMap (MapData * map)
 
 		if (!Level->blockmap.VerifyBlockMap(count, Level->lines.Size()))
 		{
-			DPrintf (DMSG_SPAMMY, "Generating BLOCKMAP\n");
-			CreateBlockMap();
+			delete[] Level->blockmap.blockmaplump;
+			Level->blockmap.blockmaplump = nullptr;
+			GenerateBlockMap();
 		}
 
 	}
@@ -2641,6 +2725,7 @@ void MapLoader::LoadBlockMap (MapData * map)
 	count = Level->blockmap.bmapwidth*Level->blockmap.bmapheight;
 	Level->blockmap.blocklinks = new FBlockNode *[count];
 	memset (Level->blockmap.blocklinks, 0, count*sizeof(*Level->blockmap.blocklinks));
+	Level->blockmap.blockthings = new FBlockThingList[count];
 	Level->blockmap.blockmap = Level->blockmap.blockmaplump+4;
 }
 
@@ -3175,6 +3260,7 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 	// set the head node for gameplay purposes. If the separate gamenodes array is not empty, use that, otherwise use the render nodes.
 	Level->headgamenode = Level->gamenodes.Size() > 0 ? &Level->gamenodes[Level->gamenodes.Size() - 1] : Level->nodes.Size() ? &Level->nodes[Level->nodes.Size() - 1] : nullptr;
 
+	OpenLevelCache(map);
 	LoadBlockMap(map);
 
 	LoadReject(map, false);
@@ -3244,17 +3330,22 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 
 	InitRenderInfo();				// create hardware independent renderer resources for the level. This must be done BEFORE the PolyObj Spawn!!!
 	Level->ClearDynamic3DFloorData();	// CreateVBO must be run on the plain 3D floor data.
-	CreateVBO(screen->mVertexData, Level->sectors);
-
-	screen->InitLightmap(Level->LMTextureSize, Level->LMTextureCount, Level->LMTextureData);
+	// The headless benchmark runs on the dummy framebuffer, which has no render resources at all.
+	if (!benchmarking)
+	{
+		CreateVBO(screen->mVertexData, Level->sectors);
+		screen->InitLightmap(Level->LMTextureSize, Level->LMTextureCount, Level->LMTextureData);
+	}
 
 	for (auto &sec : Level->sectors)
 	{
 		P_Recalculate3DFloors(&sec);
 	}
 
-	SWRenderer->SetColormap(Level);	//The SW renderer needs to do some special setup for the level's default colormap.
+	if (!benchmarking)
+		SWRenderer->SetColormap(Level);	//The SW renderer needs to do some special setup for the level's default colormap.
 	InitPortalGroups(Level);
+	BuildReject();
 	P_InitHealthGroups(Level);
 
 	if (reloop) LoopSidedefs(false);
@@ -3262,6 +3353,8 @@ void MapLoader::LoadLevel(MapData *map, const char *lumpname, int position)
 	if (!Level->IsReentering())
 		Level->FinalizePortals();	// finalize line portals after polyobjects have been initialized. This info is needed for properly flagging them.
 
+	SaveLevelCache(map);
+
 	Level->aabbTree = new DoomLevelAABBTree(Level);
 	Level->levelMesh = new DoomLevelMesh(*Level);
 	Level->mapVersion = map->version;
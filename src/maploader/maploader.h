@@ -167,6 +167,23 @@ private:
 	bool DoLoadGLNodes(FileReader * lumps);
 	void CreateCachedNodes(MapData *map);
 
+	// Level cache
+	struct FLevelCacheChunk
+	{
+		uint32_t id;
+		TArray<uint8_t> data;
+	};
+	TArray<FLevelCacheChunk> LevelCache;
+	uint32_t LevelCacheKey = 0;
+	bool LevelCacheDirty = false;
+
+	uint32_t GetLevelCacheKey();
+	uint64_t GetLevelCacheLimit();
+	void OpenLevelCache(MapData *map);
+	void SaveLevelCache(MapData *map);
+	TArray<uint8_t> *FindLevelCacheChunk(uint32_t id);
+	void StoreLevelCacheChunk(uint32_t id, TArray<uint8_t> &data);
+
 	// Render info
 	void PrepareSectorData();
 	void PrepareTransparentDoors(sector_t * sector);
@@ -232,7 +249,8 @@ private:
 	void AllocateSideDefs(MapData *map, int count);
 	void ProcessSideTextures(bool checktranmap, side_t *sd, sector_t *sec, intmapsidedef_t *msd, int special, int tag, short *alpha, FMissingTextureTracker &missingtex);
 	void SetMapThingUserData(AActor *actor, unsigned udi);
-	void CreateBlockMap();
+	unsigned CreateBlockMap();
+	void GenerateBlockMap();
 	void PO_Init(void);
 
 	// During map init the items' own Index functions should not be used.
@@ -298,6 +316,7 @@ public:
 	void LoadSideDefs2(MapData *map, FMissingTextureTracker &missingtex);
 	void LoadBlockMap(MapData * map);
 	void LoadReject(MapData * map, bool junk);
+	void BuildReject();
 	void LoadBehavior(MapData * map);
 	void GetPolySpots(MapData * map, TArray<FNodeBuilder::FPolyStart> &spots, TArray<FNodeBuilder::FPolyStart> &anchors);
 	void GroupLines(bool buildmap);
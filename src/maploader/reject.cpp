@@ -0,0 +1,311 @@
+/*
+** reject.cpp
+** Builds a conservative REJECT table for maps that do not ship one.
+**
+** Every two-sided line between two different sectors is a portal. For each
+** source sector all portal chains leaving it are followed while a straight
+** line can still pass through every portal in order, using the same
+** separating line clipping as a PVS builder. Everything a chain reaches is
+** marked visible. Sectors themselves are never used to clip (they need not be
+** convex) so the result can only err on the visible side, which keeps
+** P_CheckSight's results unchanged. Maps where following the chains takes
+** too long get no table at all.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+*/
+
+#include <atomic>
+#include <thread>
+#include <future>
+#include "doomtype.h"
+#include "doomstat.h"
+#include "p_local.h"
+#include "g_levellocals.h"
+#include "maploader.h"
+#include "c_cvars.h"
+#include "i_time.h"
+#include "printf.h"
+#include "workerpool.h"
+
+CVAR(Bool, sv_buildreject, true, CVAR_SERVERINFO)
+
+struct FRejectBuilder
+{
+	enum
+	{
+		MaxDepth = 256,			// deeper chains are treated as open
+		MaxSteps = 1 << 14,		// per source sector, after that it falls back to a plain flood
+		MaxTotalSteps = 1 << 25,	// for the whole map, after that nothing gets rejected
+		MaxSectors = 16384,		// the table grows quadratically, above this it's not worth it
+	};
+
+	static constexpr double Slack = 0.5;	// map units a point may be on the wrong side of a clip line
+
+	struct Portal
+	{
+		DVector2 v1, v2;
+		int line;
+		int sector;		// the sector on the far side
+		double farside;	// sign of PointSide() for points in the far sector
+	};
+
+	TArray<Portal> Portals;
+	TArray<TArray<int>> SectorPortals;
+	unsigned NumSectors;
+	unsigned RowBytes;
+	TArray<uint8_t> Rows;	// one bitfield row per source sector
+	TArray<uint8_t> SelfReferencing;
+	std::atomic<int64_t> TotalSteps{ 0 };
+	std::atomic<bool> Exhausted{ false };
+
+	// per source state
+	struct Work
+	{
+		uint8_t *row;
+		TArray<uint8_t> onstack;
+		int steps;
+		bool overflow;
+	};
+
+	FRejectBuilder(FLevelLocals *Level)
+	{
+		NumSectors = Level->sectors.Size();
+		RowBytes = (NumSectors + 7) >> 3;
+		SectorPortals.Resize(NumSectors);
+		SelfReferencing.Resize(NumSectors);
+		memset(SelfReferencing.Data(), 0, NumSectors);
+
+		for (auto &line : Level->lines)
+		{
+			if (line.frontsector == nullptr || line.backsector == nullptr) continue;
+			if (line.frontsector == line.backsector)
+			{
+				// Used for invisible bridges and deep water tricks, where the sector's real
+				// neighbours are whatever surrounds it, so it can't be reasoned about here.
+				SelfReferencing[line.frontsector->Index()] = 1;
+				continue;
+			}
+
+			int front = line.frontsector->Index(), back = line.backsector->Index();
+			SectorPortals[front].Push(Portals.Push({ line.v1->fPos(), line.v2->fPos(), line.Index(), back, 1. }));
+			SectorPortals[back].Push(Portals.Push({ line.v1->fPos(), line.v2->fPos(), line.Index(), front, -1. }));
+		}
+	}
+
+	// positive on the back side of a line, matching P_PointOnLineSide.
+	static double PointSide(const DVector2 &p, const DVector2 &a, const DVector2 &b)
+	{
+		DVector2 d = b - a;
+		double len = d.Length();
+		if (len == 0) return 0;
+		return (d.X * (p.Y - a.Y) - d.Y * (p.X - a.X)) / len;
+	}
+
+	// Keeps the part of the window on the 'sign' side of a-b. Returns false if nothing is left.
+	static bool ClipWindow(DVector2 &w1, DVector2 &w2, const DVector2 &a, const DVector2 &b, double sign)
+	{
+		double d1 = sign * PointSide(w1, a, b) + Slack;
+		double d2 = sign * PointSide(w2, a, b) + Slack;
+		if (d1 < 0 && d2 < 0) return false;
+		if (d1 >= 0 && d2 >= 0) return true;
+		DVector2 mid = w1 + (w2 - w1) * (d1 / (d1 - d2));
+		if (d1 < 0) w1 = mid;
+		else w2 = mid;
+		return true;
+	}
+
+	// Clips the window to the area a line through source and pass can reach.
+	static bool ClipToSeparators(DVector2 &w1, DVector2 &w2, const DVector2 (&source)[2], const DVector2 (&pass)[2])
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			for (int j = 0; j < 2; j++)
+			{
+				const DVector2 &s = source[i], &p = pass[j];
+				if (s == p) continue;
+				double ds = PointSide(source[i ^ 1], s, p);
+				double dp = PointSide(pass[j ^ 1], s, p);
+				// only a separator if source and pass lie on opposite sides.
+				if (fabs(ds) < Slack || fabs(dp) < Slack || (ds > 0) == (dp > 0)) continue;
+				if (!ClipWindow(w1, w2, s, p, dp > 0 ? 1. : -1.)) return false;
+			}
+		}
+		return true;
+	}
+
+	void Mark(Work &work, int sector)
+	{
+		work.row[sector >> 3] |= 1 << (sector & 7);
+	}
+
+	void Flow(Work &work, const DVector2 (&source)[2], const DVector2 (&pass)[2], double passfarside, int sector, int depth)
+	{
+		if (work.overflow) return;
+		if (++work.steps > MaxSteps || depth > MaxDepth)
+		{
+			work.overflow = true;
+			return;
+		}
+
+		for (int p : SectorPortals[sector])
+		{
+			auto &portal = Portals[p];
+			if (work.onstack[portal.line]) continue;
+
+			// The line must be beyond the pass portal and inside what source and pass let through.
+			DVector2 window[2] = { portal.v1, portal.v2 };
+			if (!ClipWindow(window[0], window[1], pass[0], pass[1], passfarside)) continue;
+			if (!ClipToSeparators(window[0], window[1], source, pass)) continue;
+
+			Mark(work, portal.sector);
+			work.onstack[portal.line] = 1;
+			Flow(work, source, window, portal.farside, portal.sector, depth + 1);
+			work.onstack[portal.line] = 0;
+			if (work.overflow) return;
+		}
+	}
+
+	// Fallback for sources whose portal chains are too complex: everything connected is visible.
+	void Flood(Work &work, int start)
+	{
+		TArray<int> todo;
+		todo.Push(start);
+		while (todo.Size() > 0)
+		{
+			int sector;
+			todo.Pop(sector);
+			for (int p : SectorPortals[sector])
+			{
+				int other = Portals[p].sector;
+				if (!(work.row[other >> 3] & (1 << (other & 7))))
+				{
+					Mark(work, other);
+					todo.Push(other);
+				}
+			}
+		}
+	}
+
+	// Returns false once the map's step budget is used up. Each thread can overshoot it by one row.
+	bool BuildRow(Work &work, int source)
+	{
+		if (Exhausted) return false;
+		work.row = &Rows[source * RowBytes];
+		work.steps = 0;
+		work.overflow = false;
+		Mark(work, source);
+
+		for (int p : SectorPortals[source])
+		{
+			auto &portal = Portals[p];
+			DVector2 window[2] = { portal.v1, portal.v2 };
+
+			// Any line out of the source can pass this portal, so it is both source and pass for its chains.
+			Mark(work, portal.sector);
+			work.onstack[portal.line] = 1;
+			Flow(work, window, window, portal.farside, portal.sector, 1);
+			work.onstack[portal.line] = 0;
+			if (work.overflow)
+			{
+				Flood(work, source);
+				break;
+			}
+		}
+		if ((TotalSteps += work.steps) > MaxTotalSteps)
+		{
+			Exhausted = true;
+			return false;
+		}
+		return true;
+	}
+
+	bool IsVisible(unsigned source, unsigned target) const
+	{
+		if (SelfReferencing[source] || SelfReferencing[target]) return true;
+		return !!(Rows[source * RowBytes + (target >> 3)] & (1 << (target & 7)));
+	}
+};
+
+//==========================================================================
+//
+// Creates a REJECT table if the map doesn't come with a usable one.
+// The result is stored in the level cache because it only depends on
+// the map's geometry.
+//
+//==========================================================================
+
+void MapLoader::BuildReject()
+{
+	// Portals make the sight code cross sector boundaries that have no line between them.
+	// Rejected pairs skip P_CheckSight's stealth RNG call, so demos and netgames that
+	// may have been started without a generated table have to keep doing without.
+	if (!sv_buildreject || demoplayback || demorecording || netgame || Level->rejectmatrix.Size() > 0 || Level->Displacements.size > 1 || Level->sectors.Size() < 2 || Level->sectors.Size() > FRejectBuilder::MaxSectors)
+		return;
+
+	const unsigned numsectors = Level->sectors.Size();
+	const unsigned neededsize = (numsectors * numsectors + 7) >> 3;
+
+	auto cached = FindLevelCacheChunk(MAKE_ID('R', 'J', 'C', '2'));
+	if (cached != nullptr && (cached->Size() == 0 || cached->Size() == neededsize))
+	{
+		Level->rejectmatrix = *cached;
+		return;
+	}
+
+	uint64_t startTime = I_msTime();
+	FRejectBuilder builder(Level);
+	builder.Rows.Resize(numsectors * builder.RowBytes);
+	memset(builder.Rows.Data(), 0, builder.Rows.Size());
+
+	std::atomic<unsigned> nextsector{ 0 };
+	auto buildrows = [&]()
+	{
+		FRejectBuilder::Work work;
+		work.onstack.Resize(Level->lines.Size());
+		memset(work.onstack.Data(), 0, work.onstack.Size());
+		for (unsigned s = nextsector++; s < numsectors; s = nextsector++)
+		{
+			if (!builder.BuildRow(work, s)) break;
+		}
+	};
+
+	auto &pool = WorkerPool();
+	TArray<std::future<void>> jobs;
+	for (int i = 0; i < pool.size(); i++)
+	{
+		jobs.Push(pool.push([&buildrows](int id) { buildrows(); }));
+	}
+	buildrows();
+	for (auto &job : jobs)
+	{
+		job.wait();
+	}
+
+	// Sight is symmetric, so a pair is only rejected if neither side can see the other.
+	// If the map was too complex to finish, everything stays visible.
+	TArray<uint8_t> reject(neededsize, true);
+	memset(reject.Data(), 0, neededsize);
+	bool rejectsany = false;
+	for (unsigned s = 0; s < numsectors && !builder.Exhausted; s++)
+	{
+		for (unsigned t = 0; t < numsectors; t++)
+		{
+			if (!builder.IsVisible(s, t) && !builder.IsVisible(t, s))
+			{
+				unsigned pnum = s * numsectors + t;
+				reject[pnum >> 3] |= 1 << (pnum & 7);
+				rejectsany = true;
+			}
+		}
+	}
+	if (!rejectsany) reject.Reset();
+
+	if (builder.Exhausted) DPrintf(DMSG_NOTIFY, "REJECT generation gave up after %.3f sec, map is too complex\n", (I_msTime() - startTime) * 0.001);
+	else DPrintf(DMSG_NOTIFY, "REJECT generation took %.3f sec\n", (I_msTime() - startTime) * 0.001);
+	Level->rejectmatrix = reject;
+	StoreLevelCacheChunk(MAKE_ID('R', 'J', 'C', '2'), reject);
+}
@@ -1064,6 +1064,7 @@ void FLevelLocals::Serialize(FSerializer &arc, bool hubload)
 	if (arc.isReading())
 	{
 		FinalizePortals();
+		S_PrecacheEnvironments(this);
 	}
 
 	// [ZZ] serialize health groups
@@ -410,6 +410,7 @@ void FLevelLocals::ClearLevelData(bool fullgc)
 	if (automap) automap->Destroy();
 	Behaviors.UnloadModules();
 	localEventManager->Shutdown();
+	S_ResetOcclusion();
 	if (aabbTree) delete aabbTree;
 	if (levelMesh) delete levelMesh;
 	aabbTree = nullptr;
@@ -602,16 +603,17 @@ void P_SetupLevel(FLevelLocals *Level, int position, bool newGame, int mapVersio
 	P_ClearParticles(Level);
 
 	// @Cockatrice - Flush any background texture loads
-	if (screen->SupportsBackgroundCache()) {
+	if (!benchmarking && screen->SupportsBackgroundCache()) {
 		screen->FlushBackground();
 	}
 
-	// preload graphics and sounds
-	if (precache)
+	// preload graphics and sounds. The headless benchmark has no render device to upload to.
+	if (precache && !benchmarking)
 	{
 		PrecacheLevel(Level);
 		S_PrecacheLevel(Level);
 	}
+	S_PrecacheEnvironments(Level);
 
 	if (deathmatch)
 	{
@@ -43,6 +43,8 @@
 extern gamestate_t wipegamestate;
 extern uint8_t globalfreeze, globalchangefreeze;
 
+cycle_t ParticleCycles;		// time spent thinking particles, read by the benchmark runner
+
 //==========================================================================
 //
 // P_CheckTickerPaused
@@ -152,6 +154,9 @@ void P_Ticker (void)
 	for (auto Level : AllLevels())
 	{
 		// todo: set up a sandbox for secondary levels here.
+		// @Cockatrice - No block iterator can be running here, so this is where unlinked entries get removed.
+		Level->blockmap.CompactThings();
+
 		auto it = Level->GetThinkerIterator<AActor>();
 		AActor *ac;
 
@@ -161,7 +166,9 @@ void P_Ticker (void)
 			ac->ClearFOVInterpolation();
 		}
 
+		ParticleCycles.Clock();
 		P_ThinkParticles(Level);	// [RH] make the particles think
+		ParticleCycles.Unclock();
 
 		for (i = 0; i < MAXPLAYERS; i++)
 			if (Level->PlayerInGame(i))
@@ -172,7 +179,9 @@ void P_Ticker (void)
 		Level->Tick();			// [RH] let the level tick
 		Level->Thinkers.RunThinkers(Level);
 
+		ParticleCycles.Clock();
 		P_ThinkDefinedParticles(Level); // Run after the world tick so we get proper moving sector heights
+		ParticleCycles.Unclock();
 
 		//if added by MC: Freeze mode.
 		if (!Level->isFrozen())
@@ -73,6 +73,7 @@ extern TArray<FLightDefaults *> StateLights;
 
 
 CVAR(Bool, gl_link_playerlights, false, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
+CVAR(Bool, gl_spotlight_linkcache, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG);
 
 //==========================================================================
 //
@@ -238,6 +239,8 @@ void FDynamicLight::ReleaseLight()
 	else Level->lights = next;
 	if (next != nullptr) next->prev = prev;
 	next = prev = nullptr;
+	delete linkCache;
+	linkCache = nullptr;
 	FreeList.Push(this);
 	
 	RemovePlayerLight();
@@ -591,7 +594,7 @@ struct LightLinkEntry
 };
 static TArray<LightLinkEntry> collected_ss;
 
-void FDynamicLight::CollectWithinRadius(const DVector3 &opos, FSection *section, float radius)
+void FDynamicLight::CollectWithinRadius(const DVector3 &opos, FSection *section, float radius, FLightLinkCache *cache)
 {
 	if (!section) return;
 	collected_ss.Clear();
@@ -604,7 +607,8 @@ void FDynamicLight::CollectWithinRadius(const DVector3 &opos, FSection *section,
 		auto pos = collected_ss[i].pos;
 		section = collected_ss[i].sect;
 
-		touching_sector = AddLightNode(&section->lighthead, section, this, touching_sector);
+		if (cache) cache->Sections.Push({ section, pos });
+		else touching_sector = AddLightNode(&section->lighthead, section, this, touching_sector);
 
 
 		auto processSide = [&](side_t *sidedef, const vertex_t *v1, const vertex_t *v2)
@@ -616,11 +620,13 @@ void FDynamicLight::CollectWithinRadius(const DVector3 &opos, FSection *section,
 				if ((pos.Y - v1->fY()) * (v2->fX() - v1->fX()) + (v1->fX() - pos.X) * (v2->fY() - v1->fY()) <= 0)
 				{
 					linedef->validcount = ::validcount;
-					touching_sides = AddLightNode(&sidedef->lighthead, sidedef, this, touching_sides);
+					if (cache) cache->Sides.Push({ sidedef, pos, false });
+					else touching_sides = AddLightNode(&sidedef->lighthead, sidedef, this, touching_sides);
 				}
 				else if (linedef->sidedef[0] == sidedef && linedef->sidedef[1] == nullptr)
 				{
 					hitonesidedback = true;
+					if (cache) cache->Sides.Push({ sidedef, pos, true });
 				}
 			}
 			if (linedef)
@@ -707,6 +713,45 @@ void FDynamicLight::CollectWithinRadius(const DVector3 &opos, FSection *section,
 			}
 		}
 	}
+	if (!cache) shadowmapped = hitonesidedback && !DontShadowmap();
+}
+
+// @Cockatrice - Links the part of the cached full radius set that is reached by the spot.
+// Uses the same distance test against the spot's center as CollectWithinRadiusSP but
+// only walks the cached lists, so rotating a light no longer floods through the sections.
+void FDynamicLight::LinkFromCache(const DVector3 &spotDir, float radius)
+{
+	bool hitonesidedback = false;
+	auto &sections = linkCache->Sections;
+
+	for (unsigned i = 0; i < sections.Size(); i++)
+	{
+		auto spotPos = sections[i].pos + spotDir;
+		auto section = sections[i].sect;
+		bool touched = i == 0;	// the light's own section is always linked
+
+		for (unsigned j = 0; j < section->segments.Size() && !touched; j++)
+		{
+			touched = DistToSeg(spotPos, section->segments[j].start, section->segments[j].end) <= radius;
+		}
+		for (unsigned j = 0; j < section->sides.Size() && !touched; j++)
+		{
+			touched = DistToSeg(spotPos, section->sides[j]->V1(), section->sides[j]->V2()) <= radius;
+		}
+		if (touched)
+		{
+			touching_sector = AddLightNode(&section->lighthead, section, this, touching_sector);
+		}
+	}
+
+	for (auto &entry : linkCache->Sides)
+	{
+		if (DistToSeg(entry.pos + spotDir, entry.side->V1(), entry.side->V2()) <= radius)
+		{
+			if (entry.onesidedback) hitonesidedback = true;
+			else touching_sides = AddLightNode(&entry.side->lighthead, entry.side, this, touching_sides);
+		}
+	}
 	shadowmapped = hitonesidedback && !DontShadowmap();
 }
 
@@ -864,12 +909,9 @@ void FDynamicLight::LinkLight()
 		
 
 		// @Cockatrice - If this is a spot light, collect only within a radius from the center of the spot, we don't care about stuff that is behind the spot light
-		// This helps improves performance for a light that is moving, but reduces performance significantly for lights that only rotate
-		// TODO: Mark rotating lights to avoid this tradeoff
+		// This helps improves performance for a light that is moving. Lights that only rotate filter
+		// their links from a cached full radius set that is built once the light stops moving.
 		if (IsSpot()) {
-			dl_validcount++;
-			::validcount++;
-
 			// Determine center point in the direction of the light, reduce radius by half
 			// This may not work as we may have extended outside of our sector
 			float rad = radius * 0.5f;
@@ -881,8 +923,42 @@ void FDynamicLight::LinkLight()
 			pPos.Y = rad * cospitch * angle.Sin();
 			pPos.Z = rad * -pitch.Sin();
 
-			FSection *sect = Level->PointInRenderSubsector(Pos)->section;
-			CollectWithinRadiusSP(Pos, pPos, sect, rad * rad);
+			// The full radius set covers about 4 times the area of the cone, so it only
+			// pays off once the light holds its position. While it is moving the cache
+			// just remembers where it was last linked.
+			bool cached = false;
+			if (gl_spotlight_linkcache)
+			{
+				if (linkCache == nullptr) linkCache = new FLightLinkCache;
+				if (linkCache->Pos != Pos || linkCache->Radius != radius)
+				{
+					linkCache->Sections.Clear();
+					linkCache->Sides.Clear();
+					linkCache->Pos = Pos;
+					linkCache->Radius = radius;
+				}
+				else
+				{
+					if (linkCache->Sections.Size() == 0)
+					{
+						dl_validcount++;
+						::validcount++;
+						FSection *sect = Level->PointInRenderSubsector(Pos)->section;
+						CollectWithinRadius(Pos, sect, float(radius * radius), linkCache);
+					}
+					LinkFromCache(pPos, rad * rad);
+					cached = true;
+				}
+			}
+
+			if (!cached)
+			{
+				dl_validcount++;
+				::validcount++;
+
+				FSection *sect = Level->PointInRenderSubsector(Pos)->section;
+				CollectWithinRadiusSP(Pos, pPos, sect, rad * rad);
+			}
 		}
 		else {
 			FSection *sect = Level->PointInRenderSubsector(Pos)->section;
@@ -931,6 +1007,11 @@ void FDynamicLight::UnlinkLight ()
 	while (touching_sides) touching_sides = DeleteLightNode(touching_sides);
 	while (touching_sector) touching_sector = DeleteLightNode(touching_sector);
 	shadowmapped = false;
+	if (linkCache)
+	{
+		linkCache->Sections.Clear();
+		linkCache->Sides.Clear();
+	}
 }
 
 //==========================================================================
@@ -195,6 +195,29 @@ struct FLightNode
 	};
 };
 
+// @Cockatrice - Full radius link set of a spotlight. As long as the light does not move
+// the cone's links can be filtered out of this instead of flooding the sections again.
+// It is only filled after the light was linked twice at the same position (Pos).
+struct FLightLinkCache
+{
+	struct Section
+	{
+		FSection *sect;
+		DVector3 pos;
+	};
+	struct Side
+	{
+		side_t *side;
+		DVector3 pos;
+		bool onesidedback;	// one-sided line facing away from the light, only relevant for shadowmapping
+	};
+
+	DVector3 Pos;
+	float Radius;
+	TArray<Section> Sections;
+	TArray<Side> Sides;
+};
+
 struct FDynamicLight
 {
 	friend class FLightDefaults;
@@ -285,7 +308,8 @@ struct FDynamicLight
 
 private:
 	double DistToSeg(const DVector3 &pos, vertex_t *start, vertex_t *end);
-	void CollectWithinRadius(const DVector3 &pos, FSection *section, float radius);
+	void CollectWithinRadius(const DVector3 &pos, FSection *section, float radius, FLightLinkCache *cache = nullptr);
+	void LinkFromCache(const DVector3 &spotDir, float radius);
 	void CollectWithinRadiusSP(const DVector3 &opos, const DVector3 &spotDir, FSection *section, float radius);
 
 public:
@@ -312,6 +336,7 @@ public:
 	TObjPtr<AActor *> target;
 	FLightNode * touching_sides;
 	FLightNode * touching_sector;
+	FLightLinkCache *linkCache;	// allocated on demand, the light itself gets memset on creation.
 	float radius;			// The maximum size the light can be with its current settings.
 	float m_currentRadius;	// The current light size.
 	int m_tickCount;
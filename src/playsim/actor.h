@@ -444,6 +444,7 @@ enum ActorFlag9
 	MF9_SHADOWBLOCK				= 0x00000004,	// [inkoalawetrust] Actors in the line of fire with this flag trigger the MF_SHADOW aiming penalty.
 	MF9_SHADOWAIMVERT			= 0x00000008,	// [inkoalawetrust] Monster aim is also offset vertically when aiming at shadow actors.
 	MF9_DECOUPLEDANIMATIONS	= 0x00000010,	// [RL0] Decouple model animations from states
+	MF9_TICKLOD				= 0x00000020,	// @Cockatrice - May tick less often while far away from players and not rendered
 
 	MF9_MINVISIBLE			= 0x10000000,	// Actor not visible to monsters 								(@Cockatrice - Moved from MF8 during merge to prevent conflicts)
 	MF9_MVISBLOCKED			= 0x20000000,	// Monster(only) sight checks to actor always fail 				(@Cockatrice - Moved from MF8 during merge to prevent conflicts)
@@ -820,6 +821,7 @@ public:
 	virtual void PostSerialize() override;
 	virtual void PostBeginPlay() override;		// Called immediately before the actor's first tick
 	virtual void Tick() override;
+	bool SkipTick() override;
 	void EnableNetworking(const bool enable) override;
 
 	static AActor *StaticSpawn (FLevelLocals *Level, PClassActor *type, const DVector3 &pos, replace_t allowreplacement, bool SpawningMapThing = false);
@@ -1156,6 +1158,8 @@ public:
 	int				lastScaleFlags;		// And scale flags
 	int				lastModelSprite;	// Likewise used for the last rendered model sprite, only used when unimportant
 	uint8_t			lastModelFrame;		// And the frame index
+	int				LastRenderedTic;	// @Cockatrice - Level time the renderer last looked at this actor, for tick LOD
+	int				LODTics;			// @Cockatrice - Tics skipped by tick LOD that haven't been applied yet
 	
 
 	uint32_t		RenderRequired;		// current renderer must have this feature set
@@ -1574,15 +1578,19 @@ public:
 	{
 		__Pos.X = npos.X;
 		__Pos.Y = npos.Y;
+		if (BlockNode != nullptr) UpdateBlockThings();
 	}
 	void SetXYZ(double xx, double yy, double zz)
 	{
 		__Pos = { xx,yy,zz };
+		if (BlockNode != nullptr) UpdateBlockThings();
 	}
 	void SetXYZ(const DVector3 &npos)
 	{
 		__Pos = npos;
+		if (BlockNode != nullptr) UpdateBlockThings();
 	}
+	void UpdateBlockThings();
 
 	double VelXYToSpeed() const
 	{
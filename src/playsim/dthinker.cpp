@@ -47,10 +47,12 @@
 #include "d_main.h"
 
 static int ThinkCount;
-static cycle_t ThinkCycles;
+static bool TickLOD;
+cycle_t ThinkCycles;
 extern cycle_t BotSupportCycles;
 extern cycle_t ActionCycles;
 extern int BotWTG;
+bool P_TickLODActive();
 
 IMPLEMENT_CLASS(DThinker, false, false)
 
@@ -109,6 +111,7 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 	int i, count;
 
 	ThinkCount = 0;
+	TickLOD = P_TickLODActive();
 	ThinkCycles.Reset();
 	BotSupportCycles.Reset();
 	ActionCycles.Reset();
@@ -168,6 +171,7 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 		for (i = STAT_FIRST_THINKING; i <= MAX_STATNUM; ++i)
 		{
 			if (i == STAT_SLEEP || i == STAT_SLEEP_FOREVER) { continue; }
+			if (i == STAT_DEFAULT) P_BeginSightBatch(Level);	// @Cockatrice - The players have moved by now
 			Thinkers[i].TickThinkers(nullptr);
 		}
 
@@ -181,6 +185,7 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 				count += FreshThinkers[i].TickThinkers(&Thinkers[i]);
 			}
 		} while (count != 0);
+		P_EndSightBatch();
 
 		recreateLights();
 		if (dolights)
@@ -200,6 +205,7 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 		for (i = STAT_FIRST_THINKING; i <= MAX_STATNUM; ++i)
 		{
 			if (i == STAT_SLEEP || i == STAT_SLEEP_FOREVER) { continue; }
+			if (i == STAT_DEFAULT) P_BeginSightBatch(Level);	// @Cockatrice - The players have moved by now
 			Thinkers[i].ProfileThinkers(nullptr);
 		}
 
@@ -213,6 +219,7 @@ void FThinkerCollection::RunThinkers(FLevelLocals *Level)
 				count += FreshThinkers[i].ProfileThinkers(&Thinkers[i]);
 			}
 		} while (count != 0);
+		P_EndSightBatch();
 
 		recreateLights();
 		if (dolights)
@@ -798,6 +805,12 @@ int FThinkerList::TickThinkers(FThinkerList *dest)
 			I_Error("There is a thinker in the fresh list that has already ticked.\n");
 		}
 
+		if (TickLOD && !(node->ObjectFlags & (OF_EuthanizeMe | OF_JustSpawned)) && node->SkipTick())
+		{ // @Cockatrice - Tick LOD, this one gets to catch up later
+			node = NextToThink;
+			continue;
+		}
+
 		if (!(node->ObjectFlags & OF_EuthanizeMe))
 		{ // Only tick thinkers not scheduled for destruction
 			ThinkCount++;
@@ -844,6 +857,12 @@ int FThinkerList::ProfileThinkers(FThinkerList *dest)
 			I_Error("There is a thinker in the fresh list that has already ticked.\n");
 		}
 
+		if (TickLOD && !(node->ObjectFlags & (OF_EuthanizeMe | OF_JustSpawned)) && node->SkipTick())
+		{ // @Cockatrice - Tick LOD, this one gets to catch up later
+			node = NextToThink;
+			continue;
+		}
+
 		if (!(node->ObjectFlags & OF_EuthanizeMe))
 		{ // Only tick thinkers not scheduled for destruction
 			ThinkCount++;
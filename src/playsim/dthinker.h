@@ -115,6 +115,7 @@ public:
 	void OnDestroy () override;
 	virtual ~DThinker ();
 	virtual void Tick ();
+	virtual bool SkipTick() { return false; }	// @Cockatrice - Tick LOD, see AActor::SkipTick
 	void CallTick();
 	virtual void PostBeginPlay ();	// Called just before the first tick
 	virtual void CallPostBeginPlay(); // different in actor.
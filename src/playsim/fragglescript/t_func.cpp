@@ -3287,6 +3287,7 @@ void FParser::SF_Resurrect()
 		mo->SetState(state);
 		mo->Height = mo->GetDefault()->Height;
 		mo->radius = mo->GetDefault()->radius;
+		mo->UpdateBlockThings();
 		mo->Revive();
 		mo->target = nullptr;
 	}
@@ -3570,7 +3571,10 @@ void FParser::SF_MobjRadius(void)
 		if(t_argc > 1)
 		{
 			if(mo) 
+			{
 				mo->radius = floatvalue(t_argv[1]);
+				mo->UpdateBlockThings();
+			}
 		}
 		t_return.setDouble(mo ? mo->radius : 0.);
 	}
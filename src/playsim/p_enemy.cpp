@@ -2893,6 +2893,7 @@ bool P_CheckForResurrection(AActor* self, bool usevilestates, FState* state = nu
 				{
 					corpsehit->Height = info->Height;	// [RH] Use real mobj height
 					corpsehit->radius = info->radius;	// [RH] Use real radius
+					corpsehit->UpdateBlockThings();
 				}
 
 				corpsehit->Revive();
@@ -275,6 +275,19 @@ bool	P_BounceActor (AActor *mo, AActor *BlockingMobj, bool ontop);
 bool    P_ReflectOffActor(AActor* mo, AActor* blocking);
 int	P_CheckSight (AActor *t1, AActor *t2, int flags=0);
 
+int	P_CheckSight (AActor *t1, AActor *t2, int flags, int wallblocked);	// wallblocked comes from P_PrepareSightBatch, -1 if unknown
+struct FSightQuery
+{
+	AActor *from;
+	AActor *to;
+	bool result;
+	int wallblocked;
+};
+void P_PrepareSightBatch (FSightQuery *queries, int count);
+void P_BeginSightBatch (FLevelLocals *Level);	// @Cockatrice - Batches the monsters' wall tests for this tic, see p_sight.cpp
+void P_EndSightBatch ();
+void P_CheckSightBatch (FSightQuery *queries, int count, int flags=0);
+
 enum ESightFlags
 {
 	SF_IGNOREVISIBILITY=1,
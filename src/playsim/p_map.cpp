@@ -98,6 +98,7 @@
 CVAR(Bool, cl_bloodsplats, true, CVAR_ARCHIVE)
 CVAR(Int, sv_smartaim, 0, CVAR_ARCHIVE | CVAR_SERVERINFO)
 CVAR(Bool, cl_doautoaim, false, CVAR_ARCHIVE)
+CVAR(Bool, sv_blockthingfilter, true, 0)
 
 static void CheckForPushSpecial(line_t *line, int side, AActor *mobj, DVector2 * posforwindowcheck = NULL);
 static void SpawnShootDecal(AActor *t1, AActor *defaults, const FTraceResults &trace);
@@ -1940,6 +1941,14 @@ bool P_CheckPosition(AActor *thing, const DVector2 &pos, FCheckPosition &tm, boo
 	FMultiBlockThingsIterator it2(pcheck, thing->Level, pos.X, pos.Y, thing->Z(), thing->Height, thing->radius, false, newsec);
 	FMultiBlockThingsIterator::CheckResult tcres;
 
+	// @Cockatrice - Let the iterator skip things that are too far away to touch us before they ever get here.
+	// The filter doesn't know about displaced portal groups. It's exact, but stays off for demos and
+	// netgames anyway so that sync never depends on the flat block arrays being right.
+	if (sv_blockthingfilter && thing->Level->Displacements.size <= 1 && !demoplayback && !demorecording && !netgame)
+	{
+		it2.SetThingFilter(thing->radius);
+	}
+
 	if (!(thing->flags2 & MF2_THRUACTORS))
 	while ((it2.Next(&tcres)))
 	{
@@ -341,6 +341,7 @@ void AActor::UnlinkFromWorld (FLinkContext *ctx)
 			}
 			*(block->PrevActor) = block->NextActor;
 			FBlockNode *next = block->NextBlock;
+			Level->blockmap.RemoveThing(block);
 			block->Release ();
 			block = next;
 		}
@@ -545,6 +546,7 @@ void AActor::LinkToWorld(FLinkContext *ctx, bool spawningmapthing, sector_t *sec
 						}
 						node->PrevActor = link;
 						*link = node;
+						Level->blockmap.AddThing(node);
 
 						// Link in to actor
 						node->PrevBlock = alink;
@@ -560,6 +562,79 @@ void AActor::LinkToWorld(FLinkContext *ctx, bool spawningmapthing, sector_t *sec
 	if (!spawningmapthing) UpdateRenderSectorList();
 }
 
+//==========================================================================
+//
+// FBlockmap :: AddThing / RemoveThing
+//
+// Keeps the flat thing arrays in sync with the block chains. The chains are
+// walked newest first, the arrays are ordered oldest first. Removing only
+// clears the entry, so entries never move while a tic is running and
+// iterators can keep their place across unlinks.
+//
+//==========================================================================
+
+void FBlockmap::AddThing(FBlockNode *node)
+{
+	AActor *me = node->Me;
+	node->ThingIndex = blockthings[node->BlockIndex].Things.Push({ me, node, me->X(), me->Y(), me->radius });
+}
+
+void FBlockmap::RemoveThing(FBlockNode *node)
+{
+	auto &list = blockthings[node->BlockIndex];
+	auto &thing = list.Things[node->ThingIndex];
+	thing.Me = nullptr;
+	thing.Node = nullptr;
+	if (list.Dead++ == 0) deadthings.Push(node->BlockIndex);
+}
+
+//==========================================================================
+//
+// FBlockmap :: CompactThings
+//
+// Squeezes the unlinked entries out of the blocks that have any. Must only
+// be called between tics, when no iterator can be in the middle of a block.
+//
+//==========================================================================
+
+void FBlockmap::CompactThings()
+{
+	for (int index : deadthings)
+	{
+		auto &list = blockthings[index];
+		unsigned live = 0;
+		for (unsigned i = 0; i < list.Things.Size(); i++)
+		{
+			if (list.Things[i].Me == nullptr) continue;
+			if (live != i) list.Things[live] = list.Things[i];
+			list.Things[live].Node->ThingIndex = live;
+			live++;
+		}
+		list.Things.Clamp(live);
+		list.Dead = 0;
+	}
+	deadthings.Clear();
+}
+
+//==========================================================================
+//
+// Moves the actor's flat block entries along with it. The actor only gets
+// relinked when it's done moving, but the position is needed before that.
+// Also needs to be called when the radius grows without a relink.
+//
+//==========================================================================
+
+void AActor::UpdateBlockThings()
+{
+	for (FBlockNode *node = BlockNode; node != nullptr; node = node->NextBlock)
+	{
+		auto &thing = Level->blockmap.blockthings[node->BlockIndex].Things[node->ThingIndex];
+		thing.X = X();
+		thing.Y = Y();
+		thing.Radius = radius;
+	}
+}
+
 void AActor::SetOrigin(double x, double y, double z, bool moving)
 {
 	FLinkContext ctx;
@@ -946,14 +1021,33 @@ void FBlockThingsIterator::StartBlock(int x, int y)
 	if (Level->blockmap.isValidBlock(x, y))
 	{
 		block = Level->blockmap.blocklinks[y*Level->blockmap.bmapwidth + x];
+		if (filtered)
+		{
+			thingindex = Level->blockmap.blockthings[y*Level->blockmap.bmapwidth + x].Things.Size() - 1;
+		}
 	}
 	else
 	{
 		// invalid block
 		block = NULL;
+		thingindex = -1;
 	}
 }
 
+//===========================================================================
+//
+// FBlockThingsIterator :: SetThingFilter
+//
+//===========================================================================
+
+void FBlockThingsIterator::SetThingFilter(const DVector2 &pos, double radius)
+{
+	filtered = true;
+	filterpos = pos;
+	filterradius = radius;
+	Reset();
+}
+
 //===========================================================================
 //
 // FBlockThingsIterator :: SwitchBlock
@@ -967,6 +1061,93 @@ void FBlockThingsIterator::SwitchBlock(int x, int y)
 	StartBlock(x, y);
 }
 
+//===========================================================================
+//
+// FBlockThingsIterator :: AddToHash
+//
+// Returns false if the actor was already returned from another block.
+//
+//===========================================================================
+
+bool FBlockThingsIterator::AddToHash(AActor *me)
+{
+	HashEntry *entry;
+	int i;
+
+	size_t hash = ((size_t)me >> 3) % countof(Buckets);
+	for (i = Buckets[hash]; i >= 0; )
+	{
+		entry = GetHashEntry(i);
+		if (entry->Actor == me)
+		{ // I've already been checked. Skip to the next actor.
+			return false;
+		}
+		i = entry->Next;
+	}
+	// Add me to the hash table and return me.
+	if (NumFixedHash < (int)countof(FixedHash))
+	{
+		entry = &FixedHash[NumFixedHash];
+		entry->Next = Buckets[hash];
+		Buckets[hash] = NumFixedHash++;
+	}
+	else
+	{
+		if (DynHash.Size() == 0)
+		{
+			DynHash.Grow(50);
+		}
+		i = DynHash.Reserve(1);
+		entry = &DynHash[i];
+		entry->Next = Buckets[hash];
+		Buckets[hash] = i + countof(FixedHash);
+	}
+	entry->Actor = me;
+	return true;
+}
+
+//===========================================================================
+//
+// FBlockThingsIterator :: NextFiltered
+//
+// Same as the node chain walk in Next, in the same order, but on the
+// block's flat thing array so that rejected things are never touched.
+//
+//===========================================================================
+
+AActor *FBlockThingsIterator::NextFiltered()
+{
+	if (thingindex < 0)
+		return nullptr;
+
+	// Whatever the caller did with the last thing may have unlinked or linked others. Unlinked
+	// ones are left as empty entries and new ones are added at the end, where the chain walk
+	// wouldn't see them either, so the index stays valid.
+	auto &things = Level->blockmap.blockthings[cury * Level->blockmap.bmapwidth + curx].Things;
+
+	while (thingindex >= 0)
+	{
+		FBlockThing &thing = things[thingindex--];
+		if (thing.Me == nullptr)
+			continue;
+
+		double dx = fabs(thing.X - filterpos.X), dy = fabs(thing.Y - filterpos.Y);
+		if (dx >= filterradius + thing.Radius || dy >= filterradius + thing.Radius)
+			continue;
+
+		FBlockNode *mynode = thing.Node;
+		if (mynode->NextBlock == NULL && mynode->PrevBlock == &thing.Me->BlockNode)
+		{ // This actor doesn't span blocks, so we know it can only ever be checked once.
+			return thing.Me;
+		}
+		if (AddToHash(thing.Me))
+		{
+			return thing.Me;
+		}
+	}
+	return nullptr;
+}
+
 //===========================================================================
 //
 // FBlockThingsIterator :: Next
@@ -977,12 +1158,15 @@ AActor *FBlockThingsIterator::Next(bool centeronly)
 {
 	for (;;)
 	{
-		while (block != NULL)
+		if (filtered && !centeronly)
+		{
+			AActor *me = NextFiltered();
+			if (me != nullptr) return me;
+		}
+		else while (block != NULL)
 		{
 			AActor *me = block->Me;
 			FBlockNode *mynode = block;
-			HashEntry *entry;
-			int i;
 
 			block = block->NextActor;
 			// Don't recheck things that were already checked
@@ -1005,40 +1189,9 @@ AActor *FBlockThingsIterator::Next(bool centeronly)
 					return me;
 				}
 			}
-			else
+			else if (AddToHash(me))
 			{
-				size_t hash = ((size_t)me >> 3) % countof(Buckets);
-				for (i = Buckets[hash]; i >= 0; )
-				{
-					entry = GetHashEntry(i);
-					if (entry->Actor == me)
-					{ // I've already been checked. Skip to the next actor.
-						break;
-					}
-					i = entry->Next;
-				}
-				if (i < 0)
-				{ // Add me to the hash table and return me.
-					if (NumFixedHash < (int)countof(FixedHash))
-					{
-						entry = &FixedHash[NumFixedHash];
-						entry->Next = Buckets[hash];
-						Buckets[hash] = NumFixedHash++;
-					}
-					else
-					{
-						if (DynHash.Size() == 0)
-						{
-							DynHash.Grow(50);
-						}
-						i = DynHash.Reserve(1);
-						entry = &DynHash[i];
-						entry->Next = Buckets[hash];
-						Buckets[hash] = i + countof(FixedHash);
-					}
-					entry->Actor = me;
-					return me;
-				}
+				return me;
 			}
 		}
 
@@ -293,6 +293,13 @@ class FBlockThingsIterator
 
 	FBlockNode *block;
 
+	// Things that can't touch the filter box are skipped by looking at the
+	// block's flat FBlockThing copy instead of walking the node chain.
+	bool filtered = false;
+	DVector2 filterpos;
+	double filterradius;
+	int thingindex;				// next FBlockThing to look at
+
 	int Buckets[32];
 
 	struct HashEntry
@@ -309,6 +316,8 @@ class FBlockThingsIterator
 	void StartBlock(int x, int y);
 	void SwitchBlock(int x, int y);
 	void ClearHash();
+	bool AddToHash(AActor *me);
+	AActor *NextFiltered();
 
 	// The following is only for use in the path traverser 
 	// and therefore declared private.
@@ -327,6 +336,10 @@ public:
 	void init(const FBoundingBox &box, bool clearhash = true);
 	AActor *Next(bool centeronly = false);
 	void Reset() { StartBlock(minx, miny); }
+
+	// Only returns things whose distance on both axes is less than their radius plus the given radius.
+	// This is the same early out PIT_CheckThing does, so using it doesn't change the results.
+	void SetThingFilter(const DVector2 &pos, double radius);
 };
 
 class FMultiBlockThingsIterator
@@ -360,6 +373,11 @@ public:
 	{
 		return bbox;
 	}
+	void SetThingFilter(double radius)
+	{
+		blockIterator.SetThingFilter(checkpoint.XY(), radius);
+		Reset();
+	}
 };
 
 
@@ -102,6 +102,7 @@
 #include "shadowinlines.h"
 #include "model.h"
 #include "d_net.h"
+#include "d_main.h"
 #include "p_linetracedata.h"
 
 // MACROS ------------------------------------------------------------------
@@ -147,6 +148,8 @@ FRandom pr_spawnmobj ("SpawnActor");
 FRandom pr_bounce("Bounce");
 FRandom pr_spawnmissile("SpawnMissile");
 
+cycle_t MovementCycles;		// time spent in P_XYMovement and P_ZMovement, read by the benchmark runner
+
 CUSTOM_CVAR (Float, sv_gravity, 800.f, CVAR_SERVERINFO|CVAR_NOSAVE|CVAR_NOINITCALL)
 {
 	for (auto Level : AllLevels())
@@ -389,6 +392,7 @@ void AActor::Serialize(FSerializer &arc)
 		A("viewangles", ViewAngles)
 		A("spawntime", SpawnTime)
 		A("spawnorder", SpawnOrder)
+		A("lodtics", LODTics)
 		A("friction", Friction)
 		A("SpriteOffset", SpriteOffset)
 		("viewpos", ViewPos)
@@ -441,6 +445,8 @@ void AActor::PostSerialize()
 	ClearInterpolation();
 	ClearFOVInterpolation();
 	UpdateWaterLevel(false);
+	// @Cockatrice - The renderer hasn't seen anything yet, don't let tick LOD kick in before it had a chance to
+	LastRenderedTic = Level->maptime;
 }
 
 
@@ -3865,6 +3871,70 @@ DEFINE_ACTION_FUNCTION(AActor, CheckPortalTransition)
 	return 0;
 }
 
+//==========================================================================
+//
+// @Cockatrice - Tick level of detail
+//
+// Actors with +TICKLOD that stand still, are far away from every player
+// and haven't been rendered for a while only tick every few tics. The tics
+// they skip are taken off their state durations once they tick again, so
+// their animations keep their pace. Anything else that counts tics in the
+// actor's own Tick just runs slower while it is in LOD, as do states that
+// are too short to take the skipped tics.
+// This is never active in netgames, demos and benchmarks since it isn't deterministic.
+//
+//==========================================================================
+
+CVAR(Bool, sv_ticklod, true, 0)
+CVAR(Float, sv_ticklod_distance, 2048.f, CVAR_ARCHIVE)
+CVAR(Int, sv_ticklod_interval, 4, CVAR_ARCHIVE)
+CVAR(Int, sv_ticklod_unseentics, TICRATE, CVAR_ARCHIVE)
+
+bool P_TickLODActive()
+{
+	return sv_ticklod && sv_ticklod_interval > 1 && !netgame && !demoplayback && !demorecording && !benchmarking;
+}
+
+bool AActor::SkipTick()
+{
+	if (!(flags9 & MF9_TICKLOD))
+	{
+		LODTics = 0;
+		return false;
+	}
+
+	bool lod = player == nullptr && Vel.isZero() && Level->maptime - LastRenderedTic > sv_ticklod_unseentics;
+	if (lod)
+	{
+		double lodDist = sv_ticklod_distance * sv_ticklod_distance;
+		for (int i = 0; i < MAXPLAYERS && lod; i++)
+		{
+			if (!Level->PlayerInGame(i)) continue;
+			auto p = Level->Players[i];
+			if (p->mo != nullptr && Distance2DSquared(p->mo) < lodDist) lod = false;
+			else if (p->camera != nullptr && p->camera != p->mo && Distance2DSquared(p->camera) < lodDist) lod = false;
+		}
+	}
+
+	if (lod && LODTics + 1 < sv_ticklod_interval)
+	{
+		LODTics++;
+		return true;
+	}
+
+	// Ticking this time. If still in LOD catch up with the current state as far
+	// as it goes without skipping its transition. Whatever is left, which is all
+	// of it for 1-tic states, is dropped so it can't pile up over a chain of
+	// short states. An actor that just left LOD is close or visible again and
+	// doesn't get to jump ahead.
+	if (lod && tics > 1)
+	{
+		tics -= min(LODTics, tics - 1);
+	}
+	LODTics = 0;
+	return false;
+}
+
 //
 // P_MobjThinker
 //
@@ -4302,7 +4372,9 @@ void AActor::Tick ()
 		Blocking3DFloor = nullptr;
 		BlockingFloor = nullptr;
 		BlockingCeiling = nullptr;
+		MovementCycles.Clock();
 		double oldfloorz = P_XYMovement (this, cumm);
+		MovementCycles.Unclock();
 		if (ObjectFlags & OF_EuthanizeMe)
 		{ // actor was destroyed
 			return;
@@ -4330,7 +4402,9 @@ void AActor::Tick ()
 			{
 				if (!(onmo = P_CheckOnmobj (this)))
 				{
+					MovementCycles.Clock();
 					P_ZMovement (this, oldfloorz);
+					MovementCycles.Unclock();
 					flags2 &= ~MF2_ONMOBJ;
 				}
 				else
@@ -4394,7 +4468,9 @@ void AActor::Tick ()
 			}
 			else
 			{
+				MovementCycles.Clock();
 				P_ZMovement (this, oldfloorz);
+				MovementCycles.Unclock();
 			}
 
 			if (ObjectFlags & OF_EuthanizeMe)
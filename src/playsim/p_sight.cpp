@@ -36,6 +36,7 @@
 
 #include "g_levellocals.h"
 #include "actorinlines.h"
+#include "hw_aabbtree.h"
 
 static FRandom pr_botchecksight ("BotCheckSight");
 static FRandom pr_checksight ("CheckSight");
@@ -51,8 +52,8 @@ This uses specialized forms of the maputils routines for optimized performance
 */
 
 // Performance meters
-static int sightcounts[6];
-static cycle_t SightCycles;
+static int sightcounts[7];
+cycle_t SightCycles;
 static cycle_t MaxSightCycles;
 
 enum
@@ -845,7 +846,115 @@ sightcounts[2]++;
 =====================
 */
 
-int P_CheckSight (AActor *t1, AActor *t2, int flags)
+//==========================================================================
+//
+// The level's AABB tree holds every one-sided line. A segment between the
+// actors that crosses one of them can never be seen through, whatever the
+// heights are, so this can reject sight without walking the blockmap.
+// Portals move the sight line between groups, so maps with them skip this.
+//
+//==========================================================================
+
+CVAR(Bool, sv_sighttree, true, CVAR_SERVERINFO)
+
+static bool P_CanUseSightTree(FLevelLocals *Level)
+{
+	return sv_sighttree && Level->aabbTree != nullptr && Level->linePortals.Size() == 0 && Level->Displacements.size <= 1;
+}
+
+//==========================================================================
+//
+// Per-tic sight batch
+//
+// Right before the monsters think, the wall tests of every live monster
+// towards its target, or towards the players while it has none, are done
+// in a single tree walk. P_CheckSight picks a result up as long as neither
+// actor has moved since. Everything else gets the single tree test, and
+// whatever the tree can't decide (two-sided lines, 3D floors, portals)
+// still goes through the blockmap traversal below.
+//
+//==========================================================================
+
+struct FSightBatch
+{
+	FLevelLocals *Level = nullptr;
+	TArray<FSightQuery> Queries;	// grouped by looker
+	TArray<DVector2> Starts, Ends;	// positions the wall tests were done with
+	TMap<AActor *, unsigned> First;	// first query of each looker
+};
+
+static FSightBatch SightBatch;
+
+static void AddBatchedSight(AActor *from, AActor *to)
+{
+	SightBatch.Queries.Push({ from, to, false, -1 });
+	SightBatch.Starts.Push(from->Pos().XY());
+	SightBatch.Ends.Push(to->Pos().XY());
+}
+
+void P_BeginSightBatch(FLevelLocals *Level)
+{
+	P_EndSightBatch();
+	if (!P_CanUseSightTree(Level)) return;
+
+	auto it = Level->GetThinkerIterator<AActor>(NAME_None, STAT_DEFAULT);
+	AActor *mo;
+	while ((mo = it.Next()))
+	{
+		if (!(mo->flags3 & MF3_ISMONSTER) || mo->health <= 0 || (mo->flags2 & MF2_DORMANT)) continue;
+
+		unsigned first = SightBatch.Queries.Size();
+		if (mo->target != nullptr)
+		{
+			if (mo->target != mo) AddBatchedSight(mo, mo->target);
+		}
+		else for (int i = 0; i < MAXPLAYERS; i++)
+		{
+			if (!Level->PlayerInGame(i)) continue;
+			auto pmo = Level->Players[i]->mo;
+			if (pmo != nullptr && pmo != mo && pmo->health > 0) AddBatchedSight(mo, pmo);
+		}
+		if (SightBatch.Queries.Size() > first) SightBatch.First[mo] = first;
+	}
+
+	// A single query gains nothing from the packet walk.
+	if (SightBatch.Queries.Size() < 2)
+	{
+		P_EndSightBatch();
+		return;
+	}
+	SightBatch.Level = Level;
+	P_PrepareSightBatch(SightBatch.Queries.Data(), SightBatch.Queries.Size());
+}
+
+void P_EndSightBatch()
+{
+	SightBatch.Level = nullptr;
+	SightBatch.Queries.Clear();
+	SightBatch.Starts.Clear();
+	SightBatch.Ends.Clear();
+	SightBatch.First.Clear();
+}
+
+static int P_FindBatchedSight(AActor *t1, AActor *t2)
+{
+	if (SightBatch.Level != t1->Level) return -1;
+
+	auto first = SightBatch.First.CheckKey(t1);
+	if (first == nullptr) return -1;
+
+	for (unsigned i = *first; i < SightBatch.Queries.Size() && SightBatch.Queries[i].from == t1; i++)
+	{
+		if (SightBatch.Queries[i].to == t2)
+		{
+			if (SightBatch.Starts[i] != t1->Pos().XY() || SightBatch.Ends[i] != t2->Pos().XY()) return -1;
+			return SightBatch.Queries[i].wallblocked;
+		}
+	}
+	return -1;
+}
+
+int P_CheckSight (AActor *t1, AActor *t2, int flags, int wallblocked)
 {
 	SightCycles.Clock();
 
@@ -911,6 +1020,25 @@ sightcounts[0]++;
 		}
 	}
 
+	// A one-sided wall between both actors always blocks.
+	if (wallblocked < 0)
+	{
+		wallblocked = P_FindBatchedSight(t1, t2);
+	}
+	if (wallblocked < 0 && P_CanUseSightTree(t1->Level))
+	{
+		DVector2 start = t1->Pos().XY(), end = t2->Pos().XY();
+		bool blocked;
+		t1->Level->aabbTree->SegmentsBlocked(&start, &end, 1, &blocked);
+		wallblocked = blocked;
+	}
+	if (wallblocked > 0)
+	{
+sightcounts[6]++;
+		res = false;
+		goto done;
+	}
+
 	// An unobstructed LOS is possible.
 	// Now look from eyes of t1 to any part of t2.
 
@@ -950,12 +1078,68 @@ done:
 	return res;
 }
 
+int P_CheckSight (AActor *t1, AActor *t2, int flags)
+{
+	return P_CheckSight(t1, t2, flags, -1);
+}
+
+//==========================================================================
+//
+// Does the wall test of a batch of sight queries in one go against the
+// AABB tree and stores it in each query's wallblocked, for passing to
+// P_CheckSight later. This has no side effects, so callers can still run
+// their checks (and random calls) in the original order and skip the
+// ones they don't need.
+//
+//==========================================================================
+
+void P_PrepareSightBatch (FSightQuery *queries, int count)
+{
+	if (count <= 0) return;
+
+	for (int i = 0; i < count; i++) queries[i].wallblocked = -1;
+	if (queries[0].from == nullptr || !P_CanUseSightTree(queries[0].from->Level)) return;
+
+	TArray<DVector2> starts(count, true), ends(count, true);
+	TArray<bool> blocked(count, true);
+	for (int i = 0; i < count; i++)
+	{
+		// Invalid pairs are handled by P_CheckSight itself.
+		starts[i] = queries[i].from ? queries[i].from->Pos().XY() : DVector2(0, 0);
+		ends[i] = queries[i].to ? queries[i].to->Pos().XY() : DVector2(0, 0);
+	}
+	SightCycles.Clock();
+	queries[0].from->Level->aabbTree->SegmentsBlocked(starts.Data(), ends.Data(), count, blocked.Data());
+	SightCycles.Unclock();
+
+	for (int i = 0; i < count; i++)
+	{
+		if (queries[i].from != nullptr && queries[i].to != nullptr) queries[i].wallblocked = blocked[i];
+	}
+}
+
+//==========================================================================
+//
+// Checks a batch of sight queries. The results are the same as calling
+// P_CheckSight for each query in order, including the random checks.
+//
+//==========================================================================
+
+void P_CheckSightBatch (FSightQuery *queries, int count, int flags)
+{
+	P_PrepareSightBatch(queries, count);
+	for (int i = 0; i < count; i++)
+	{
+		queries[i].result = !!P_CheckSight(queries[i].from, queries[i].to, flags, queries[i].wallblocked);
+	}
+}
+
 ADD_STAT (sight)
 {
 	FString out;
-	out.Format ("%04.1f ms (%04.1f max), %5d %2d%4d%4d%4d%4d\n",
+	out.Format ("%04.1f ms (%04.1f max), %5d %2d%4d%4d%4d%4d%4d\n",
 		SightCycles.TimeMS(), MaxSightCycles.TimeMS(),
-		sightcounts[3], sightcounts[0], sightcounts[1], sightcounts[2], sightcounts[4], sightcounts[5]);
+		sightcounts[3], sightcounts[0], sightcounts[6], sightcounts[1], sightcounts[2], sightcounts[4], sightcounts[5]);
 	return out;
 }
 
@@ -32,7 +32,7 @@
 #include "p_effect.h"
 #include "po_man.h"
 #include "m_fixed.h"
-#include "ctpl.h"
+#include "workerpool.h"
 #include "texturemanager.h"
 #include "hwrenderer/scene/hw_fakeflat.h"
 #include "hwrenderer/scene/hw_clipper.h"
@@ -55,7 +55,6 @@ EXTERN_CVAR(Bool, r_radarclipper)
 EXTERN_CVAR(Bool, r_dithertransparency)
 
 thread_local bool isWorkerThread;
-ctpl::thread_pool renderPool(4);
 bool inited = false;
 
 const int MAXDITHERACTORS = 20; // Maximum number of enemies that can set dither-transparency flags
@@ -150,6 +149,7 @@ void HWDrawInfo::WorkerThread()
 		{
 		case RenderJob::TerminateJob:
 			WTTotal.Unclock();
+			isWorkerThread = false;	// the thread goes back to the shared pool
 			return;
 
 		case RenderJob::WallJob:
@@ -1073,7 +1073,7 @@ void HWDrawInfo::RenderBSP(void *node, bool drawpsprites)
 	if (multithread)
 	{
 		jobQueue.ReleaseAll();
-		auto future = renderPool.push([&](int id) {
+		auto future = WorkerPool().push([&](int id) {
 			WorkerThread();
 		});
 		if (Viewpoint.IsOrtho() && ((Level->flags3 & LEVEL3_NOFOGOFWAR) || !r_radarclipper)) RenderOrthoNoFog();
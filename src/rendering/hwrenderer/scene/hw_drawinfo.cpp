@@ -514,11 +514,9 @@ void HWDrawInfo::RenderScene(FRenderState &state)
 
 	if (gl_sort_textures)
 	{
-		drawlists[GLDL_PLAINWALLS].SortWalls();
-		drawlists[GLDL_PLAINFLATS].SortFlats();
-		drawlists[GLDL_MASKEDWALLS].SortWalls();
-		drawlists[GLDL_MASKEDFLATS].SortFlats();
-		drawlists[GLDL_MASKEDWALLSOFS].SortWalls();
+		HWDrawList *sortlists[] = { &drawlists[GLDL_PLAINWALLS], &drawlists[GLDL_PLAINFLATS], &drawlists[GLDL_MASKEDWALLS], &drawlists[GLDL_MASKEDFLATS], &drawlists[GLDL_MASKEDWALLSOFS] };
+		static const bool sortwalls[] = { true, false, true, false, true };
+		SortDrawListsByTexture(sortlists, sortwalls, countof(sortlists));
 	}
 
 	// Part 1: solid geometry. This is set up so that there are no transparent parts
@@ -38,6 +38,67 @@
 #include "hw_drawinfo.h"
 #include "hw_fakeflat.h"
 #include "hw_walldispatcher.h"
+#include "c_cvars.h"
+#include "workerpool.h"
+
+//==========================================================================
+//
+// @Cockatrice - Stable LSD radix sort for pre-computed 64 bit sort keys.
+// Byte positions that are the same for all keys are skipped, so narrow
+// keys (e.g. texture indices) only take a few passes.
+//
+//==========================================================================
+
+static void RadixSortKeys(TArray<FDrawSortKey> &keys)
+{
+	enum { SmallSortMax = 32 };
+
+	unsigned count = keys.Size();
+	if (count <= SmallSortMax)
+	{
+		std::stable_sort(keys.begin(), keys.end(), [](const FDrawSortKey &a, const FDrawSortKey &b) { return a.Key < b.Key; });
+		return;
+	}
+
+	static thread_local TArray<FDrawSortKey> scratch;
+	scratch.Resize(count);
+	FDrawSortKey *src = keys.Data(), *dest = scratch.Data();
+
+	unsigned histogram[8][256] = {};
+	for (unsigned i = 0; i < count; i++)
+	{
+		uint64_t key = src[i].Key;
+		for (int b = 0; b < 8; b++) histogram[b][(key >> (b * 8)) & 255]++;
+	}
+
+	for (int b = 0; b < 8; b++)
+	{
+		auto &h = histogram[b];
+		int shift = b * 8;
+		if (h[(src[0].Key >> shift) & 255] == count) continue;
+
+		unsigned offsets[256], sum = 0;
+		for (int d = 0; d < 256; d++)
+		{
+			offsets[d] = sum;
+			sum += h[d];
+		}
+		for (unsigned i = 0; i < count; i++)
+		{
+			dest[offsets[(src[i].Key >> shift) & 255]++] = src[i];
+		}
+		std::swap(src, dest);
+	}
+	if (src != keys.Data()) memcpy(keys.Data(), src, count * sizeof(FDrawSortKey));
+}
+
+// Maps a float to an unsigned int with the same ordering.
+static inline uint32_t SortableFloat(float f)
+{
+	uint32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
 
 FMemArena RenderDataAllocator(1024*1024);	// Use large blocks to reduce allocation time.
 
@@ -617,20 +678,28 @@ SortNode * HWDrawList::SortSpriteList(SortNode * head)
 
 	SortNode * parent=head->parent;
 
+	static TArray<FDrawSortKey> sortkeys;
+
+	// Farthest first, then by index. Same order as CompareSprites.
 	sortspritelist.Clear();
-	for(count=0,n=head;n;n=n->next) sortspritelist.Push(n);
-	std::stable_sort(sortspritelist.begin(), sortspritelist.end(), [=](SortNode *a, SortNode *b)
+	sortkeys.Clear();
+	for(count=0,n=head;n;n=n->next)
 	{
-		return CompareSprites(a, b) < 0;
-	});
+		HWSprite *sp = sprites[drawitems[n->itemindex].index];
+		uint32_t index = uint32_t(sp->index) ^ 0x80000000u;
+		if (reverseSort) index = ~index;
+		sortkeys.Push({ (uint64_t(~SortableFloat(sp->depth)) << 32) | index, sortspritelist.Push(n) });
+	}
+	RadixSortKeys(sortkeys);
 
-	for(i=0;i<sortspritelist.Size();i++)
+	for(i=0;i<sortkeys.Size();i++)
 	{
-		sortspritelist[i]->next=NULL;
-		if (parent) parent->equal=sortspritelist[i];
-		parent=sortspritelist[i];
+		SortNode *node = sortspritelist[sortkeys[i].Value];
+		node->next=NULL;
+		if (parent) parent->equal=node;
+		parent=node;
 	}
-	return sortspritelist[0];
+	return sortspritelist[sortkeys[0].Value];
 }
 
 //==========================================================================
@@ -723,21 +792,36 @@ void HWDrawList::Sort(HWDrawInfo *di)
 //
 // Sorting the drawitems first by texture and then by light level
 //
+// @Cockatrice - The sort keys are collected once per item so the sort itself
+// doesn't have to chase the item pointers for every comparison.
+//
 //==========================================================================
 
+static uint64_t TextureSortKey(FGameTexture *tex)
+{
+	return tex != nullptr ? uint64_t(uint32_t(tex->GetID().GetIndex() + 1)) : 0;
+}
+
+void HWDrawList::ApplySortKeys(TArray<FDrawSortKey> &sortkeys)
+{
+	static thread_local TArray<HWDrawItem> items;
+	RadixSortKeys(sortkeys);
+	items = drawitems;
+	for (unsigned i = 0; i < drawitems.Size(); i++) drawitems[i] = items[sortkeys[i].Value];
+}
+
 void HWDrawList::SortWalls()
 {
 	if (drawitems.Size() > 1)
 	{
-		std::sort(drawitems.begin(), drawitems.end(), [=](const HWDrawItem &a, const HWDrawItem &b) -> bool
+		static thread_local TArray<FDrawSortKey> sortkeys;
+		sortkeys.Resize(drawitems.Size());
+		for (unsigned i = 0; i < drawitems.Size(); i++)
 		{
-			HWWall * w1 = walls[a.index];
-			HWWall * w2 = walls[b.index];
-
-			if (w1->texture != w2->texture) return w1->texture < w2->texture;
-			return (w1->flags & 3) < (w2->flags & 3);
-
-		});
+			HWWall *w = walls[drawitems[i].index];
+			sortkeys[i] = { (TextureSortKey(w->texture) << 2) | (w->flags & 3), i };
+		}
+		ApplySortKeys(sortkeys);
 	}
 }
 
@@ -745,15 +829,53 @@ void HWDrawList::SortFlats()
 {
 	if (drawitems.Size() > 1)
 	{
-		std::sort(drawitems.begin(), drawitems.end(), [=](const HWDrawItem &a, const HWDrawItem &b)
+		static thread_local TArray<FDrawSortKey> sortkeys;
+		sortkeys.Resize(drawitems.Size());
+		for (unsigned i = 0; i < drawitems.Size(); i++)
 		{
-			HWFlat * w1 = flats[a.index];
-			HWFlat* w2 = flats[b.index];
-			return w1->texture < w2->texture;
-		});
+			sortkeys[i] = { TextureSortKey(flats[drawitems[i].index]->texture), i };
+		}
+		ApplySortKeys(sortkeys);
 	}
 }
 
+//==========================================================================
+//
+// @Cockatrice - Sorts the opaque lists by texture. They don't share any
+// data so with enough items they get sorted on worker threads.
+//
+//==========================================================================
+
+CVAR(Bool, gl_parallelsort, true, CVAR_ARCHIVE)
+
+void SortDrawListsByTexture(HWDrawList **lists, const bool *walls, int count)
+{
+	enum { ParallelSortMin = 4096 };
+
+	unsigned total = 0;
+	for (int i = 0; i < count; i++) total += lists[i]->Size();
+
+	auto sort = [=](int i)
+	{
+		if (walls[i]) lists[i]->SortWalls();
+		else lists[i]->SortFlats();
+	};
+
+	if (!gl_parallelsort || total < ParallelSortMin || count < 2)
+	{
+		for (int i = 0; i < count; i++) sort(i);
+		return;
+	}
+
+	auto &pool = WorkerPool();
+	TArray<std::future<void>> jobs;
+	for (int i = 1; i < count; i++)
+	{
+		if (lists[i]->Size() > 1) jobs.Push(pool.push([=](int) { sort(i); }));
+	}
+	sort(0);
+	for (auto &job : jobs) job.wait();
+}
 
 //==========================================================================
 //
@@ -35,6 +35,12 @@ struct HWDrawItem
 	HWDrawItem(HWDrawItemType _rendertype,int _index) : rendertype(_rendertype),index(_index) {}
 };
 
+struct FDrawSortKey
+{
+	uint64_t Key;
+	unsigned Value;
+};
+
 struct SortNode
 {
 	int itemindex;
@@ -92,6 +98,7 @@ public:
 	HWFlat *NewFlat();
 	HWSprite *NewSprite();
 	void Reset();
+	void ApplySortKeys(TArray<FDrawSortKey> &sortkeys);
 	void SortWalls();
 	void SortFlats();
 	
@@ -120,4 +127,6 @@ public:
 	HWDrawList * next;
 } ;
 
+void SortDrawListsByTexture(HWDrawList **lists, const bool *walls, int count);
+
 
@@ -781,6 +781,9 @@ void HWSprite::Process(HWDrawInfo *di, AActor* thing, sector_t * sector, area_t
 		return;
 	}
 
+	// @Cockatrice - Keep this out of tick LOD while it can be seen.
+	thing->LastRenderedTic = thing->Level->maptime;
+
 #if 0
 	if (thing->IsKindOf(NAME_Corona))
 	{
@@ -932,6 +935,91 @@ void HWSprite::Process(HWDrawInfo *di, AActor* thing, sector_t * sector, area_t
 	{
 		return;
 	}
+
+	// Model textures will only load in the background thread if they are considered unimportant (Hacky solution)
+	// Because some models may define the visible world. In that case they should be precached to avoid stutter
+	// This WILL cause breakages in animations that use multiple frames and multiple skins but that is not
+	// something that happens in Selaco yet so :ascii shrug:
+	// This also does not support animated textures as skins, frames beyond 0 will end up loading in the main thread
+	if (/*(thing->flags8 & UNIMPORTANT_FLAG) &&*/
+		modelframe &&
+		gametic - primaryLevel->starttime > 2 &&	// On the first tic or so, do not use the background loader to avoid pop-in
+		gl_texture_thread &&
+		(spritenum != thing->lastModelSprite || thing->frame != thing->lastModelFrame) &&		// only if this is a new frame or model
+		screen->SupportsBackgroundCache()) {
+
+		bool success = true;
+
+		// Voxel palettes are left to the main thread, only their mesh is built in the background
+		if (!modelframe->isVoxel) {
+			// Verify all model textures are loaded, and if they are not submit and fallback
+			for (int x = modelframe->skinIDs.Size() - 1; x >= 0; x--) {
+				auto tex = TexMan.GetGameTexture(modelframe->skinIDs[x], false);
+				if (!tex || !tex->isValid()) continue;	// Nothing we can do here
+
+				int scaleflags = 0;
+				if (shouldUpscale(tex, UF_Sprite)) scaleflags |= CTF_Upscale;
+
+				FMaterial* gltex = FMaterial::ValidateTexture(tex, scaleflags, false);
+				if (!gltex || !gltex->IsHardwareCached(thing->Translation.index())) {
+					if (gltex) {
+						screen->BackgroundCacheMaterial(gltex, thing->Translation, false);
+					}
+					else {
+						screen->BackgroundCacheTextureMaterial(tex, thing->Translation, scaleflags, false);
+					}
+
+					success = false;
+				}
+			}
+
+			// Do the same for surface skins
+			for (int x = modelframe->surfaceskinIDs.Size() - 1; x >= 0; x--) {
+				auto tex = TexMan.GetGameTexture(modelframe->surfaceskinIDs[x], false);
+				if (!tex || !tex->isValid()) continue;	// Nothing we can do here
+
+				int scaleflags = 0;
+				if (shouldUpscale(tex, UF_Sprite)) scaleflags |= CTF_Upscale;
+
+				FMaterial* gltex = FMaterial::ValidateTexture(tex, scaleflags, false);
+				if (!gltex || !gltex->IsHardwareCached(thing->Translation.index())) {
+					if (gltex) {
+						screen->BackgroundCacheMaterial(gltex, thing->Translation, false);
+					}
+					else {
+						screen->BackgroundCacheTextureMaterial(tex, thing->Translation, scaleflags, false);
+					}
+
+					success = false;
+				}
+			}
+		}
+
+		// Make sure the current model sprite is loaded
+		for (int x = 0; x < modelframe->modelsAmount; x++) {
+			int id = modelframe->modelIDs[x];
+			if (id >= 0) {
+				auto* model = Models[id];
+				if (!model->GetVertexBuffer(GLModelRendererType)) {
+					if (screen->BackgroundLoadModel(model)) {
+						success = false;
+					}
+				}
+			}
+		}
+
+		if (!success) {
+			// @Cockatrice - Attempt the last frame that was drawn. If this model has never been drawn
+			// fall back to the sprite frame until the loader threads are done with it
+			modelframe = thing->lastModelSprite > -1 ? FindModelFrame(thing, thing->lastModelSprite, thing->lastModelFrame, !!(thing->flags & MF_DROPPED)) : nullptr;
+			modelframeflags = modelframe ? modelframe->getFlags(thing->modelData) : 0;
+		}
+		else {
+			thing->lastModelSprite = spritenum;
+			thing->lastModelFrame = thing->frame;
+		}
+	}
+
 	if (!modelframe)
 	{
 		bool mirror = false;
@@ -1179,92 +1267,6 @@ void HWSprite::Process(HWDrawInfo *di, AActor* thing, sector_t * sector, area_t
 		y1 = y2 = y;
 		z1 = z2 = z;
 		texture = nullptr;
-
-
-		// Model textures will only load in the background thread if they are considered unimportant (Hacky solution)
-		// Because some models may define the visible world. In that case they should be precached to avoid stutter
-		// This WILL cause breakages in animations that use multiple frames and multiple skins but that is not
-		// something that happens in Selaco yet so :ascii shrug:
-		// This also does not support animated textures as skins, frames beyond 0 will end up loading in the main thread
-		if (/*(thing->flags8 & UNIMPORTANT_FLAG) &&*/
-			!modelframe->isVoxel &&						// completely ignore voxels
-			gametic - primaryLevel->starttime > 2 &&	// On the first tic or so, do not use the background loader to avoid pop-in
-			gl_texture_thread &&
-			(spritenum != thing->lastModelSprite || thing->frame != thing->lastModelFrame) &&		// only if this is a new frame or model
-			screen->SupportsBackgroundCache()) {
-
-			bool success = true;
-
-			// Verify all model textures are loaded, and if they are not submit and fallback
-			for (int x = modelframe->skinIDs.Size() - 1; x >= 0; x--) {
-				auto tex = TexMan.GetGameTexture(modelframe->skinIDs[x], false);
-				if (!tex || !tex->isValid()) continue;	// Nothing we can do here
-
-				int scaleflags = 0;
-				if (shouldUpscale(tex, UF_Sprite)) scaleflags |= CTF_Upscale;
-
-				FMaterial* gltex = FMaterial::ValidateTexture(tex, scaleflags, false);
-				if (!gltex || !gltex->IsHardwareCached(thing->Translation.index())) {
-					if (gltex) {
-						screen->BackgroundCacheMaterial(gltex, thing->Translation, false);
-					}
-					else {
-						screen->BackgroundCacheTextureMaterial(tex, thing->Translation, scaleflags, false);
-					}
-
-					success = false;
-				}
-			}
-
-			// Do the same for surface skins
-			for (int x = modelframe->surfaceskinIDs.Size() - 1; x >= 0; x--) {
-				auto tex = TexMan.GetGameTexture(modelframe->surfaceskinIDs[x], false);
-				if (!tex || !tex->isValid()) continue;	// Nothing we can do here
-
-				int scaleflags = 0;
-				if (shouldUpscale(tex, UF_Sprite)) scaleflags |= CTF_Upscale;
-
-				FMaterial* gltex = FMaterial::ValidateTexture(tex, scaleflags, false);
-				if (!gltex || !gltex->IsHardwareCached(thing->Translation.index())) {
-					if (gltex) {
-						screen->BackgroundCacheMaterial(gltex, thing->Translation, false);
-					}
-					else {
-						screen->BackgroundCacheTextureMaterial(tex, thing->Translation, scaleflags, false);
-					}
-
-					success = false;
-				}
-			}
-
-			// Make sure the current model sprite is loaded
-			for (int x = 0; x < modelframe->modelsAmount; x++) {
-				int id = modelframe->modelIDs[x];
-				if (id > 0) {
-					auto* model = Models[id];
-					if (!model->GetVertexBuffer(GLModelRendererType)) {
-						if (screen->BackgroundLoadModel(model)) {
-							success = false;
-						}
-					}
-				}
-			}
-
-			if (!success) {
-				// Attempt the last frame that was drawn
-				if (thing->lastModelSprite > -1) {
-					modelframe = FindModelFrame(thing, thing->lastModelSprite, thing->lastModelFrame, !!(thing->flags& MF_DROPPED));
-					if (!modelframe) return; // Farted here too
-				}
-				else {
-					return;	// Farted up here haven't we
-				}
-			}
-			else {
-				thing->lastModelSprite = spritenum;
-				thing->lastModelFrame = thing->frame;
-			}
-		}
 	}
 
 	depth = (float)((x - vp.Pos.X) * vp.TanCos + (y - vp.Pos.Y) * vp.TanSin);
@@ -356,6 +356,7 @@ static FFlagDef ActorFlagDefs[]=
 	DEFINE_FLAG(MF9, SHADOWBLOCK, AActor, flags9),
 	DEFINE_FLAG(MF9, SHADOWAIMVERT, AActor, flags9),
 	DEFINE_FLAG(MF9, DECOUPLEDANIMATIONS, AActor, flags9),
+	DEFINE_FLAG(MF9, TICKLOD, AActor, flags9),
 	DEFINE_FLAG(MF9, BLOCKLOS, AActor, flags9),
 
 	// Effect flags
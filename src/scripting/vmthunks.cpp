@@ -1014,6 +1014,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(_Sector, SetXOffset, SetXOffset)
  static void SetEnvironmentID(sector_t *self, int envnum)
  {
 	 self->Level->Zones[self->ZoneNumber].Environment = S_FindEnvironment(envnum);
+	 S_PrecacheEnvironment(self->Level->Zones[self->ZoneNumber].Environment);
  }
 
  DEFINE_ACTION_FUNCTION_NATIVE(_Sector, SetEnvironmentID, SetEnvironmentID)
@@ -1027,6 +1028,7 @@ DEFINE_ACTION_FUNCTION_NATIVE(_Sector, SetXOffset, SetXOffset)
  static void SetEnvironment(sector_t *self, const FString &env)
  {
 	 self->Level->Zones[self->ZoneNumber].Environment = S_FindEnvironment(env.GetChars());
+	 S_PrecacheEnvironment(self->Level->Zones[self->ZoneNumber].Environment);
  }
 
  DEFINE_ACTION_FUNCTION_NATIVE(_Sector, SetEnvironment, SetEnvironment)
@@ -364,6 +364,32 @@ void S_PrecacheLevel(FLevelLocals* Level)
 	}
 }
 
+//==========================================================================
+//
+// S_PrecacheEnvironments
+//
+// Has the sound backend build the reverb of every zone, plus the
+// underwater one, so moving between zones doesn't have to.
+//
+//==========================================================================
+
+void S_PrecacheEnvironment(const ReverbContainer* env)
+{
+	if (GSnd && env) GSnd->PrecacheEnvironment(env);
+}
+
+void S_PrecacheEnvironments(FLevelLocals* Level)
+{
+	if (GSnd == nullptr || Level != primaryLevel) return;
+
+	S_PrecacheEnvironment(DefaultEnvironments[0]);
+	S_PrecacheEnvironment(S_FindEnvironment(0x1600));
+	for (auto& zone : Level->Zones)
+	{
+		S_PrecacheEnvironment(zone.Environment);
+	}
+}
+
 
 //==========================================================================
 //
@@ -916,6 +942,7 @@ void S_UpdateSounds (AActor *listenactor)
 		SN_UpdateActiveSequences(Level);
 	}
 
+	S_UpdateOcclusion(listenactor);
 	soundEngine->UpdateSounds(primaryLevel->time);
 }
 
@@ -1002,8 +1029,9 @@ void S_SerializeSounds(FSerializer &arc)
 			for (unsigned int i = chans.Size(); i-- != 0; )
 			{
 				// Replace start time with sample position.
+				// Evicted channels already have it, they have no voice to ask.
 				uint64_t start = chans[i]->StartTime;
-				chans[i]->StartTime = GSnd ? GSnd->GetPosition(chans[i]) : 0;
+				if (!(chans[i]->ChanFlags & CHANF_ABSTIME)) chans[i]->StartTime = GSnd ? GSnd->GetPosition(chans[i]) : 0;
 				arc(nullptr, *chans[i]);
 				chans[i]->StartTime = start;
 			}
@@ -4,6 +4,7 @@
 struct sector_t;
 struct FPolyObj;
 struct FLevelLocals;
+struct ReverbContainer;
 
 void S_Init();
 void S_InitData();
@@ -11,8 +12,12 @@ void S_Start();
 void S_Shutdown();
 
 void S_UpdateSounds(AActor* listenactor);
+void S_UpdateOcclusion(AActor* listenactor);
+void S_ResetOcclusion();
 
 void S_PrecacheLevel(FLevelLocals* l);
+void S_PrecacheEnvironments(FLevelLocals* l);
+void S_PrecacheEnvironment(const ReverbContainer* env);
 
 FSoundHandle S_Sound(int channel, EChanFlags flags, FSoundID sfxid, float volume, float attenuation);
 FSoundHandle S_SoundPitch(int channel, EChanFlags flags, FSoundID sfxid, float volume, float attenuation, float pitch, float startTime = 0.f);
@@ -0,0 +1,295 @@
+/*
+** s_occlusion.cpp
+** Muffles sounds that are heard through walls.
+**
+** Once per frame the positions of the listener and of the playing 3D
+** sounds that were tested longest ago are copied and handed to a worker,
+** which casts a few rays between them against the one-sided lines of the
+** level's AABB tree. The fraction of blocked rays becomes the sound's
+** occlusion, which fades in and out on the game thread and is passed to
+** the sound backend as a gain and a lowpass. Sectors the REJECT table
+** says can't see each other are fully occluded without a ray test.
+**
+** The worker only ever reads the static part of the tree, which doesn't
+** change while the level is loaded. S_ResetOcclusion must be called
+** before the tree is deleted.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+*/
+
+#include <future>
+#include "actor.h"
+#include "g_levellocals.h"
+#include "hw_aabbtree.h"
+#include "s_sound.h"
+#include "i_sound.h"
+#include "c_cvars.h"
+#include "i_time.h"
+#include "stats.h"
+#include "workerpool.h"
+
+CVAR(Bool, snd_occlusion, true, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)
+CVAR(Float, snd_occlusiongain, 0.6f, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)		// Gain of a sound behind a wall
+CVAR(Float, snd_occlusionhf, 0.2f, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)		// High frequency gain of a sound behind a wall
+CVAR(Int, snd_occlusionbatch, 32, CVAR_ARCHIVE | CVAR_GLOBALCONFIG)		// Sounds tested per frame
+
+enum
+{
+	OCCLUSION_RAYS = 4,			// SegmentsBlocked tests 4 segments at once
+};
+
+static constexpr double OcclusionSpread = 16;	// Distance between the rays at the source end
+static constexpr float OcclusionFadeRate = 4.f;	// Occlusion changes by this much per second
+
+struct FOcclusionRequest
+{
+	int HandleID;
+	DVector2 Start, End;
+};
+
+struct FOcclusionResult
+{
+	int HandleID;
+	float Occlusion;
+};
+
+struct FOcclusionState
+{
+	float Target;
+	float Current;
+	int LastTest;		// Frame of the last request, the oldest ones are tested first
+	int LastSeen;
+	float SentGain, SentHF;	// Last values passed to the backend
+	void *SysChannel;	// A different source doesn't have the filter yet
+};
+
+struct FSoundOcclusion
+{
+	std::future<void> Job;
+	TMap<int, FOcclusionState> States;
+	const hwrenderer::LevelAABBTree *Tree = nullptr;
+	int Frame = 0;
+	uint64_t LastUpdate = 0;
+	int Tested = 0, Occluded = 0;
+	bool WasInWater = false;
+
+	// Reused every frame. Requests and everything after it belong to the worker while Job is valid.
+	TArray<FSoundChan *> Candidates;
+	TArray<int> Stale;
+	TArray<FOcclusionRequest> Requests;
+	TArray<DVector2> RayStarts, RayEnds;
+	TArray<bool> RayBlocked;
+	TArray<FOcclusionResult> Results;
+
+	void Wait()
+	{
+		if (Job.valid()) Job.wait();
+		Job = {};
+	}
+};
+
+// Not a static object, level destructors still call S_ResetOcclusion at exit.
+static FSoundOcclusion &Occlusion = *new FSoundOcclusion;
+
+//==========================================================================
+//
+// Runs on the worker. Casts the rays for each request against the tree.
+//
+//==========================================================================
+
+static void TestOcclusion(FSoundOcclusion &occ, const hwrenderer::LevelAABBTree *tree)
+{
+	const auto &requests = occ.Requests;
+	const unsigned count = requests.Size() * OCCLUSION_RAYS;
+	auto &starts = occ.RayStarts, &ends = occ.RayEnds;
+	auto &blocked = occ.RayBlocked;
+	starts.Resize(count);
+	ends.Resize(count);
+	blocked.Resize(count);
+
+	for (unsigned i = 0; i < requests.Size(); i++)
+	{
+		auto &req = requests[i];
+		DVector2 dir = req.End - req.Start;
+		double len = dir.Length();
+		DVector2 side = len > 0 ? DVector2(-dir.Y, dir.X) / len : DVector2(0, 0);
+
+		// Spread the far ends across the source so a wall's corner only partially occludes it.
+		for (int r = 0; r < OCCLUSION_RAYS; r++)
+		{
+			double offset = (r - (OCCLUSION_RAYS - 1) * 0.5) * OcclusionSpread;
+			starts[i * OCCLUSION_RAYS + r] = req.Start;
+			ends[i * OCCLUSION_RAYS + r] = req.End + side * offset;
+		}
+	}
+	const_cast<hwrenderer::LevelAABBTree *>(tree)->SegmentsBlocked(starts.Data(), ends.Data(), count, blocked.Data());
+
+	auto &results = occ.Results;
+	results.Resize(requests.Size());
+	for (unsigned i = 0; i < requests.Size(); i++)
+	{
+		int hits = 0;
+		for (int r = 0; r < OCCLUSION_RAYS; r++) hits += blocked[i * OCCLUSION_RAYS + r];
+		results[i] = { requests[i].HandleID, hits / float(OCCLUSION_RAYS) };
+	}
+}
+
+//==========================================================================
+//
+// S_ResetOcclusion
+//
+// Waits for the worker and forgets all results. Must be called before the
+// level's AABB tree goes away.
+//
+//==========================================================================
+
+void S_ResetOcclusion()
+{
+	Occlusion.Wait();
+	Occlusion.States.Clear();
+	Occlusion.Tree = nullptr;
+}
+
+//==========================================================================
+//
+// S_UpdateOcclusion
+//
+//==========================================================================
+
+static bool CanOcclude(const FSoundChan *chan, const void *listenobject)
+{
+	if ((chan->ChanFlags & (CHANF_IS3D | CHANF_EVICTED | CHANF_RESERVED | CHANF_UI)) != CHANF_IS3D) return false;
+	if (chan->SysChannel == nullptr || chan->SourceType == SOURCE_None) return false;
+	return chan->SourceType != SOURCE_Actor || chan->Source != listenobject;
+}
+
+void S_UpdateOcclusion(AActor *listenactor)
+{
+	auto &occ = Occlusion;
+	uint64_t now = I_msTime();
+	float fade = occ.LastUpdate > 0 ? (now - occ.LastUpdate) * 0.001f * OcclusionFadeRate : 1.f;
+	occ.LastUpdate = now;
+	occ.Frame++;
+
+	FLevelLocals *Level = listenactor != nullptr ? listenactor->Level : nullptr;
+	auto tree = Level != nullptr ? Level->aabbTree : nullptr;
+	// Portals move sound between places that have no line between them.
+	bool enabled = snd_occlusion && tree != nullptr && Level->linePortals.Size() == 0 && Level->Displacements.size <= 1;
+
+	if (occ.Tree != tree)
+	{
+		S_ResetOcclusion();
+		occ.Tree = tree;
+	}
+
+	// Pick up the worker's last results.
+	if (occ.Job.valid() && occ.Job.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		occ.Job.get();
+		for (auto &res : occ.Results)
+		{
+			auto state = occ.States.CheckKey(res.HandleID);
+			if (state) state->Target = res.Occlusion;
+		}
+		occ.Job = {};
+	}
+
+	const auto &listener = soundEngine->GetListener();
+	auto &candidates = occ.Candidates;
+	candidates.Clear();
+	occ.Occluded = 0;
+
+	// Entering or leaving water reroutes every source through the environment's filter.
+	bool inwater = listener.underwater || (listener.Environment != nullptr && listener.Environment->SoftwareWater);
+	bool waterchanged = inwater != occ.WasInWater;
+	occ.WasInWater = inwater;
+
+	for (auto chan = soundEngine->GetChannels(); chan != nullptr; chan = chan->NextChan)
+	{
+		if (!CanOcclude(chan, listener.ListenerObject)) continue;
+
+		auto state = occ.States.CheckKey(chan->HandleID);
+		if (state == nullptr)
+		{
+			state = &occ.States.Insert(chan->HandleID, { 0.f, 0.f, 0, 0, 1.f, 1.f, nullptr });
+		}
+		state->LastSeen = occ.Frame;
+		if (!enabled) state->Target = 0;
+		else candidates.Push(chan);
+
+		if (state->Current < state->Target) state->Current = std::min(state->Current + fade, state->Target);
+		else if (state->Current > state->Target) state->Current = std::max(state->Current - fade, state->Target);
+
+		// Only sent when it changes, or when the source was restarted and lost its filter.
+		float gain = 1.f - state->Current * (1.f - clamp<float>(snd_occlusiongain, 0.f, 1.f));
+		float gainhf = 1.f - state->Current * (1.f - clamp<float>(snd_occlusionhf, 0.f, 1.f));
+		bool restarted = state->SysChannel != chan->SysChannel || waterchanged;
+		state->SysChannel = chan->SysChannel;
+		if (gain != state->SentGain || gainhf != state->SentHF || (restarted && (gain < 1.f || gainhf < 1.f)))
+		{
+			GSnd->ChannelOcclusion(chan, gain, gainhf);
+			state->SentGain = gain;
+			state->SentHF = gainhf;
+		}
+		if (state->Current > 0) occ.Occluded++;
+	}
+
+	// Forget sounds that have stopped.
+	auto &stale = occ.Stale;
+	stale.Clear();
+	decltype(occ.States)::Iterator it(occ.States);
+	decltype(occ.States)::Pair *pair;
+	while (it.NextPair(pair))
+	{
+		if (pair->Value.LastSeen != occ.Frame) stale.Push(pair->Key);
+	}
+	for (int id : stale) occ.States.Remove(id);
+
+	if (!enabled || occ.Job.valid() || candidates.Size() == 0) return;
+
+	// Only the sounds that were tested longest ago go to the worker.
+	std::stable_sort(candidates.begin(), candidates.end(), [&](FSoundChan *a, FSoundChan *b)
+	{
+		return occ.States.CheckKey(a->HandleID)->LastTest < occ.States.CheckKey(b->HandleID)->LastTest;
+	});
+
+	auto &requests = occ.Requests;
+	requests.Clear();
+	unsigned batch = std::min<unsigned>(candidates.Size(), std::max<int>(snd_occlusionbatch, 1));
+	DVector2 listenpos(listener.position.X, listener.position.Z);
+
+	for (unsigned i = 0; i < batch; i++)
+	{
+		auto chan = candidates[i];
+		auto state = occ.States.CheckKey(chan->HandleID);
+		state->LastTest = occ.Frame;
+
+		FVector3 pos;
+		soundEngine->CalcPosVel(chan, &pos, nullptr);
+		DVector2 sourcepos(pos.X, pos.Z);
+
+		// The reject table is cheap enough to check right here.
+		if (!Level->CheckReject(listenactor->Sector, Level->PointInSector(sourcepos)))
+		{
+			state->Target = 1.f;
+			continue;
+		}
+		requests.Push({ chan->HandleID, listenpos, sourcepos });
+	}
+	occ.Tested = requests.Size();
+	if (requests.Size() == 0) return;
+
+	occ.Job = WorkerPool().push([&occ, tree](int)
+	{
+		TestOcclusion(occ, tree);
+	});
+}
+
+ADD_STAT(occlusion)
+{
+	return FStringf("%u sounds tracked, %d occluded, %d tested last batch%s", Occlusion.States.CountUsed(), Occlusion.Occluded, Occlusion.Tested, snd_occlusion ? "" : " (off)");
+}
@@ -41,13 +41,24 @@
 #include <string.h>
 #include <math.h>
 
+#include <thread>
+#include <future>
+
 #include "doomdata.h"
 #include "nodebuild.h"
+#include "c_cvars.h"
+#include "workerpool.h"
+
+EXTERN_CVAR(Bool, gl_multithreadnodes)
 
 const int MaxSegs = 64;
 const int SplitCost = 8;
 const int AAPreference = 16;
 
+// Candidates * segs in the set below which splitters are rated on the calling thread.
+// Under this the cost of waking the pool is higher than the work itself.
+const double ParallelRatingWork = 32768;
+
 #if 0
 #define D(x) x
 #else
@@ -428,7 +439,7 @@ bool FNodeBuilder::ShoveSegBehind (uint32_t set, node_t &node, uint32_t seg, uin
 		node.dx = -node.dx;
 		node.dy = -node.dy;
 	}
-	return Heuristic (node, set, false) > 0;
+	return Heuristic (node, set, false, Touched, Colinear) > 0;
 }
 
 // Splitters are chosen to coincide with segs in the given set. To reduce the
@@ -444,6 +455,7 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 	int bestvalue;
 	uint32_t bestseg;
 	uint32_t seg;
+	unsigned int setsize = 0;
 	bool nosplitters = false;
 
 	bestvalue = 0;
@@ -456,6 +468,9 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 
 	D(Printf (PRINT_LOG, "Processing set %d\n", set));
 
+	// Which segs get rated only depends on the plane and step bookkeeping,
+	// never on the scores, so collect them first and rate them afterwards.
+	Candidates.Clear();
 	while (seg != UINT_MAX)
 	{
 		FPrivSeg *pseg = &Segs[seg];
@@ -473,28 +488,34 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 				}
 
 				stepleft = step;
-				SetNodeFromSeg (node, pseg);
-
-				int value = Heuristic (node, set, nosplit);
-
-				D(Printf (PRINT_LOG, "Seg %5d, ld %d (%5d,%5d)-(%5d,%5d) scores %d\n", seg, Segs[seg].linedef, node.x>>16, node.y>>16,
-					(node.x+node.dx)>>16, (node.y+node.dy)>>16, value));
-
-				if (value > bestvalue)
-				{
-					bestvalue = value;
-					bestseg = seg;
-				}
-				else if (value < 0)
-				{
-					nosplitters = true;
-				}
+				Candidates.Push (seg);
 			}
 		}
 
+		setsize++;
 		seg = pseg->next;
 	}
 
+	RateSplitters (set, setsize, nosplit);
+
+	// Pick the best one in the same order the serial search would have
+	for (unsigned int i = 0; i < Candidates.Size(); ++i)
+	{
+		int value = CandidateScores[i];
+
+		D(Printf (PRINT_LOG, "Seg %5d, ld %d scores %d\n", Candidates[i], Segs[Candidates[i]].linedef, value));
+
+		if (value > bestvalue)
+		{
+			bestvalue = value;
+			bestseg = Candidates[i];
+		}
+		else if (value < 0)
+		{
+			nosplitters = true;
+		}
+	}
+
 	if (bestseg == UINT_MAX)
 	{
 		// No lines split any others into two sets, so this is a convex region.
@@ -509,13 +530,67 @@ int FNodeBuilder::SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg
 	return 1;
 }
 
+//==========================================================================
+//
+// Runs Heuristic() for every collected candidate. Scoring a splitter only
+// reads the seg and vertex arrays, so on big sets the candidates are
+// spread over the worker pool. Each score lands in its own
+// slot so the result is identical to the serial path.
+//
+//==========================================================================
+
+void FNodeBuilder::RateSplitters (uint32_t set, unsigned int setsize, bool nosplit)
+{
+	const unsigned int numcandidates = Candidates.Size();
+	CandidateScores.Resize (numcandidates);
+
+	auto rate = [&](unsigned int start, unsigned int end, TArray<int> &touched, TArray<int> &colinear)
+	{
+		node_t testnode;
+		for (unsigned int i = start; i < end; ++i)
+		{
+			SetNodeFromSeg (testnode, &Segs[Candidates[i]]);
+			CandidateScores[i] = Heuristic (testnode, set, nosplit, touched, colinear);
+		}
+	};
+
+	if (!gl_multithreadnodes || numcandidates < 2 || double(numcandidates) * setsize < ParallelRatingWork)
+	{
+		rate (0, numcandidates, Touched, Colinear);
+		return;
+	}
+
+	auto &pool = WorkerPool();
+	unsigned int numchunks = std::min<unsigned int>(pool.size() + 1, numcandidates);
+	unsigned int chunksize = (numcandidates + numchunks - 1) / numchunks;
+
+	TArray<std::future<void>> jobs;
+	for (unsigned int start = chunksize; start < numcandidates; start += chunksize)
+	{
+		unsigned int end = std::min(start + chunksize, numcandidates);
+		jobs.Push (pool.push([&rate, start, end](int id)
+		{
+			TArray<int> touched, colinear;
+			rate (start, end, touched, colinear);
+		}));
+	}
+
+	// The calling thread takes the first chunk
+	rate (0, std::min(chunksize, numcandidates), Touched, Colinear);
+
+	for (auto &job : jobs)
+	{
+		job.wait();
+	}
+}
+
 // Given a splitter (node), returns a score based on how "good" the resulting
 // split in a set of segs is. Higher scores are better. -1 means this splitter
 // splits something it shouldn't and will only be returned if honorNoSplit is
 // true. A score of 0 means that the splitter does not split any of the segs
 // in the set.
 
-int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
+int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit, TArray<int> &touched, TArray<int> &colinear) const
 {
 	// Set the initial score above 0 so that near vertex anti-weighting is less likely to produce a negative score.
 	int score = 1000000;
@@ -530,8 +605,8 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 	unsigned int max, m2, p, q;
 	double frac;
 
-	Touched.Clear ();
-	Colinear.Clear ();
+	touched.Clear ();
+	colinear.Clear ();
 
 	while (i != UINT_MAX)
 	{
@@ -557,32 +632,32 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 			{
 				if ((sidev[0] | sidev[1]) != 0)
 				{
-					max = Touched.Size();
+					max = touched.Size();
 					for (p = 0; p < max; ++p)
 					{
-						if (Touched[p] == test->loopnum)
+						if (touched[p] == test->loopnum)
 						{
 							break;
 						}
 					}
 					if (p == max)
 					{
-						Touched.Push (test->loopnum);
+						touched.Push (test->loopnum);
 					}
 				}
 				else
 				{
-					max = Colinear.Size();
+					max = colinear.Size();
 					for (p = 0; p < max; ++p)
 					{
-						if (Colinear[p] == test->loopnum)
+						if (colinear[p] == test->loopnum)
 						{
 							break;
 						}
 					}
 					if (p == max)
 					{
-						Colinear.Push (test->loopnum);
+						colinear.Push (test->loopnum);
 					}
 				}
 			}
@@ -624,8 +699,8 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 			frac = InterceptVector (node, *test);
 			if (frac < 0.001 || frac > 0.999)
 			{
-				FPrivVert *v1 = &Vertices[test->v1];
-				FPrivVert *v2 = &Vertices[test->v2];
+				const FPrivVert *v1 = &Vertices[test->v1];
+				const FPrivVert *v2 = &Vertices[test->v2];
 				double x = v1->x, y = v1->y;
 				x += frac * (v2->x - x);
 				y += frac * (v2->y - y);
@@ -699,8 +774,8 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 	// seg of that sector must be crossing the container's corner and does not
 	// actually split the container.
 
-	max = Touched.Size ();
-	m2 = Colinear.Size ();
+	max = touched.Size ();
+	m2 = colinear.Size ();
 
 	// If honorNoSplit is false, then both these lists will be empty.
 
@@ -713,10 +788,10 @@ int FNodeBuilder::Heuristic (node_t &node, uint32_t set, bool honorNoSplit)
 
 	for (p = 0; p < max; ++p)
 	{
-		int look = Touched[p];
+		int look = touched[p];
 		for (q = 0; q < m2; ++q)
 		{
-			if (look == Colinear[q])
+			if (look == colinear[q])
 			{
 				break;
 			}
@@ -1071,7 +1146,7 @@ void FNodeBuilder::RemoveSegFromVert2 (uint32_t segnum, int vertnum)
 	}
 }
 
-double FNodeBuilder::InterceptVector (const node_t &splitter, const FPrivSeg &seg)
+double FNodeBuilder::InterceptVector (const node_t &splitter, const FPrivSeg &seg) const
 {
 	double v2x = (double)Vertices[seg.v1].x;
 	double v2y = (double)Vertices[seg.v1].y;
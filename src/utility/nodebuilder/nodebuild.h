@@ -269,6 +269,9 @@ private:
 	TArray<int> Colinear;	// Loops with edges colinear to a splitter
 	FEventTree Events;		// Vertices intersected by the current splitter
 
+	TArray<uint32_t> Candidates;		// Segs to rate as splitters for the current set
+	TArray<int> CandidateScores;		// Heuristic() result for each candidate
+
 	TArray<uint32_t> UnsetSegs;			// Segs with no definitive side in current splitter
 	TArray<FSplitSharer> SplitSharers;	// Segs colinear with the current splitter
 
@@ -297,17 +300,18 @@ private:
 	bool CheckSubsectorOverlappingSegs (uint32_t set, node_t &node, uint32_t &splitseg);
 	bool ShoveSegBehind (uint32_t set, node_t &node, uint32_t seg, uint32_t mate);
 	int SelectSplitter (uint32_t set, node_t &node, uint32_t &splitseg, int step, bool nosplit);
+	void RateSplitters (uint32_t set, unsigned int setsize, bool nosplit);
 	void DoGLSegSplit (uint32_t set, node_t &node, uint32_t splitseg, uint32_t &outset0, uint32_t &outset1, int side, int sidev0, int sidev1, bool hack);
 	void SplitSegs (uint32_t set, node_t &node, uint32_t splitseg, uint32_t &outset0, uint32_t &outset1, unsigned int &count0, unsigned int &count1);
 	uint32_t SplitSeg (uint32_t segnum, int splitvert, int v1InFront);
-	int Heuristic (node_t &node, uint32_t set, bool honorNoSplit);
+	int Heuristic (node_t &node, uint32_t set, bool honorNoSplit, TArray<int> &touched, TArray<int> &colinear) const;
 
 	// Returns:
 	//	0 = seg is in front
 	//  1 = seg is in back
 	// -1 = seg cuts the node
 
-	int ClassifyLine (node_t &node, const FPrivVert *v1, const FPrivVert *v2, int sidev[2]);
+	static int ClassifyLine (const node_t &node, const FPrivVert *v1, const FPrivVert *v2, int sidev[2]);
 
 	void FixSplitSharers (const node_t &node);
 	double AddIntersection (const node_t &node, int vertex);
@@ -326,7 +330,7 @@ private:
 
 	static int SortSegs (const void *a, const void *b);
 
-	double InterceptVector (const node_t &splitter, const FPrivSeg &seg);
+	double InterceptVector (const node_t &splitter, const FPrivSeg &seg) const;
 
 	void PrintSet (int l, uint32_t set);
 